@@ -0,0 +1,8 @@
+#ifndef CHUNKED_VECTOR_H
+#define CHUNKED_VECTOR_H
+
+#include "stl_chunked_vector.h"
+
+
+
+#endif // CHUNKED_VECTOR_H
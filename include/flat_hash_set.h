@@ -0,0 +1,8 @@
+#ifndef FLAT_HASH_SET_H
+#define FLAT_HASH_SET_H
+
+#include "stl_flat_hash_set.h"
+#include "stl_algobase.h"
+#include "stl_flat_hashtable.h"
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef MMAP_VECTOR_H
+#define MMAP_VECTOR_H
+
+#include "stl_mmap_vector.h"
+
+
+
+#endif // MMAP_VECTOR_H
@@ -0,0 +1,8 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "stl_small_vector.h"
+
+
+
+#endif // SMALL_VECTOR_H
@@ -375,22 +375,38 @@ ForwardIterator adjacent_find(ForwardIterator first, ForwardIterator last, Binar
 
 // count
 
+template <class InputIterator, class T>
+inline typename iterator_traits<InputIterator>::difference_type
+__count(InputIterator first, InputIterator last, const T& value, false_type) {
+  typename iterator_traits<InputIterator>::difference_type n = 0;
+  for (; first != last; ++first)
+    if (*first == value)
+      ++n;
+  return n;
+}
+
+template <class InputIterator, class T>
+inline typename iterator_traits<InputIterator>::difference_type
+__count(InputIterator first, InputIterator last, const T& value, true_type) {
+  return static_cast<typename iterator_traits<InputIterator>::difference_type>(
+      __simd_count(first, last, value));
+}
+
 /**
  * @brief 统计等于给定值的元素个数
  * 
+ * 迭代器是指向算术类型的原生指针且 value 与元素类型相同时，使用 SIMD 内核。
+ * 
  * @param first 序列的起始迭代器
  * @param last 序列的结束迭代器
  * @param value 要统计的值
  * @return difference_type 等于 value 的元素个数
  */
 template <class InputIterator, class T>
-typename iterator_traits<InputIterator>::difference_type
+inline typename iterator_traits<InputIterator>::difference_type
 count(InputIterator first, InputIterator last, const T& value) {
-  typename iterator_traits<InputIterator>::difference_type n = 0;
-  for (; first != last; ++first)
-    if (*first == value)
-      ++n;
-  return n;
+  typedef typename __simd_find_ok<InputIterator, T>::type simd;
+  return __count(first, last, value, simd());
 }
 
 // count_if
@@ -416,19 +432,32 @@ count_if(InputIterator first, InputIterator last, Predicate pred) {
 /******************************************************************************** */
 // find
 
+template <class InputIterator, class T>
+inline InputIterator __find(InputIterator first, InputIterator last, const T& value, false_type) {
+  while (first != last && *first != value)
+    ++first;
+  return first;
+}
+
+template <class InputIterator, class T>
+inline InputIterator __find(InputIterator first, InputIterator last, const T& value, true_type) {
+  return first + (__simd_find(first, last, value) - first);
+}
+
 /**
  * @brief 查找等于给定值的第一个元素
  * 
+ * 迭代器是指向算术类型的原生指针且 value 与元素类型相同时，使用 SIMD 内核。
+ * 
  * @param first 序列的起始迭代器
  * @param last 序列的结束迭代器
  * @param value 要查找的值
  * @return InputIterator 指向第一个等于 value 的元素的迭代器。如果未找到，返回 last。
  */
 template <class InputIterator, class T>
-InputIterator find(InputIterator first, InputIterator last, const T& value) {
-  while (first != last && *first != value)
-    ++first;
-  return first;
+inline InputIterator find(InputIterator first, InputIterator last, const T& value) {
+  typedef typename __simd_find_ok<InputIterator, T>::type simd;
+  return __find(first, last, value, simd());
 }
 
 // find_if
@@ -996,24 +1025,38 @@ bool includes(InputIterator1 first1, InputIterator1 last1,
 /****************************************************************************************** */
 //max_element 
 
+template <class ForwardIterator>
+inline ForwardIterator __max_element(ForwardIterator first, ForwardIterator last, false_type) {
+  if (first == last) return first;
+  ForwardIterator result = first;
+  while (++first != last) {
+    if (*result < *first)
+      result = first;
+  }
+  return result;
+}
+
+// 先求出最大值，再找它第一次出现的位置
+template <class ForwardIterator>
+inline ForwardIterator __max_element(ForwardIterator first, ForwardIterator last, true_type) {
+  if (first == last) return first;
+  return first + (__simd_find(first, last, __simd_max_value(first, last)) - first);
+}
+
 /**
  * @brief 查找最大元素
  * 
  * 在范围 [first, last) 中查找最大元素。
+ * 原生指针区间且元素是 8/16/32 位整数时，使用 SIMD 内核。
  * 
  * @param first 序列的起始迭代器
  * @param last 序列的结束迭代器
  * @return ForwardIterator 指向最大元素的迭代器。如果序列为空，返回 first。
  */
 template <class ForwardIterator>
-ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
-  if (first == last) return first;
-  ForwardIterator result = first;
-  while (++first != last) {
-    if (*result < *first)
-      result = first;
-  }
-  return result;
+inline ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
+  typedef typename __simd_ordered_ok<ForwardIterator>::type simd;
+  return __max_element(first, last, simd());
 }
 
 /**
@@ -1042,24 +1085,38 @@ ForwardIterator max_element(ForwardIterator first, ForwardIterator last,
 /****************************************************************************************** */
 //min_element
 
+template <class ForwardIterator>
+inline ForwardIterator __min_element(ForwardIterator first, ForwardIterator last, false_type) {
+  if (first == last) return first;
+  ForwardIterator result = first;
+  while (++first != last) {
+    if (*first < *result)
+      result = first;
+  }
+  return result;
+}
+
+// 先求出最小值，再找它第一次出现的位置
+template <class ForwardIterator>
+inline ForwardIterator __min_element(ForwardIterator first, ForwardIterator last, true_type) {
+  if (first == last) return first;
+  return first + (__simd_find(first, last, __simd_min_value(first, last)) - first);
+}
+
 /**
  * @brief 查找最小元素
  * 
  * 在范围 [first, last) 中查找最小元素。
+ * 原生指针区间且元素是 8/16/32 位整数时，使用 SIMD 内核。
  * 
  * @param first 序列的起始迭代器
  * @param last 序列的结束迭代器
  * @return ForwardIterator 指向最小元素的迭代器。如果序列为空，返回 first。
  */
 template <class ForwardIterator>
-ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
-  if (first == last) return first;
-  ForwardIterator result = first;
-  while (++first != last) {
-    if (*first < *result)
-      result = first;
-  }
-  return result;
+inline ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
+  typedef typename __simd_ordered_ok<ForwardIterator>::type simd;
+  return __min_element(first, last, simd());
 }
 
 /**
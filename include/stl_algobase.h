@@ -3,6 +3,7 @@
 
 #include "stl_iterator.h"
 #include "stl_pair.h"
+#include "stl_simd.h"
 #include <cstring>
 #if MYSTL_CPP_VERSION >= 11
 #include "utility.h"
@@ -36,7 +37,7 @@ inline const T& min(const T& a, const T& b, Compare comp){
 /*equal*/
 
 template<typename InputIterator1, typename InputIterator2>
-bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
+inline bool __equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, false_type){
     for(; first1 != last1; ++first1, ++first2){
         if(*first1 != *first2){
             return false;
@@ -45,6 +46,18 @@ bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
     return true;
 }
 
+// 指向同一种算术类型的原生指针, 使用 SIMD 内核
+template<typename InputIterator1, typename InputIterator2>
+inline bool __equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, true_type){
+    return __simd_mismatch(first1, last1, first2) == static_cast<size_t>(last1 - first1);
+}
+
+template<typename InputIterator1, typename InputIterator2>
+inline bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2){
+    typedef typename __simd_range_ok<InputIterator1, InputIterator2>::type simd;
+    return __equal(first1, last1, first2, simd());
+}
+
 template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
 bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, BinaryPredicate pred){
     for(; first1 != last1; ++first1, ++first2){
@@ -510,11 +523,10 @@ copy_backward(const wchar_t* first, const wchar_t* last, wchar_t* result) {
 /*---------------------------------------------------------------------------*/
 /*mismatch*/
 
-// 比较两个序列的第一个不匹配的元素
 template <class InputIterator1, class InputIterator2>
 inline pair<InputIterator1, InputIterator2>
-mismatch(InputIterator1 first1, InputIterator1 last1,
-         InputIterator2 first2) {
+__mismatch(InputIterator1 first1, InputIterator1 last1,
+           InputIterator2 first2, false_type) {
   while (first1 != last1 && *first1 == *first2) {
     ++first1;
     ++first2;
@@ -522,6 +534,23 @@ mismatch(InputIterator1 first1, InputIterator1 last1,
   return pair<InputIterator1, InputIterator2>(first1, first2);
 }
 
+template <class InputIterator1, class InputIterator2>
+inline pair<InputIterator1, InputIterator2>
+__mismatch(InputIterator1 first1, InputIterator1 last1,
+           InputIterator2 first2, true_type) {
+  size_t n = __simd_mismatch(first1, last1, first2);
+  return pair<InputIterator1, InputIterator2>(first1 + n, first2 + n);
+}
+
+// 比较两个序列的第一个不匹配的元素; 原生指针区间使用 SIMD 内核
+template <class InputIterator1, class InputIterator2>
+inline pair<InputIterator1, InputIterator2>
+mismatch(InputIterator1 first1, InputIterator1 last1,
+         InputIterator2 first2) {
+  typedef typename __simd_range_ok<InputIterator1, InputIterator2>::type simd;
+  return __mismatch(first1, last1, first2, simd());
+}
+
 template<class InputIterator1, class InputIterator2, class BinaryPredicate>
 inline pair<InputIterator1, InputIterator2>
 mismatch(InputIterator1 first1, InputIterator1 last1,
@@ -544,6 +573,20 @@ inline void swap(T& a, T& b) {
   b = tmp;
 }
 
+/*----------------------------------------------------------------------*/
+/*bit helpers*/
+
+// 最低位的 1 之前 0 的个数, w 不能为 0
+inline unsigned __bit_ctz(unsigned long long w) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(w));
+#else
+    unsigned n = 0;
+    for (; !(w & 1); w >>= 1) ++n;
+    return n;
+#endif
+}
+
 }// namespace msl
 
 
@@ -3,13 +3,35 @@
 
 
 
+#include "stl_config.h"
+#include "stl_type_traits.h"
 #include <new>    
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
+#if MYSTL_CPP_VERSION >= 11
+#include <mutex>
+#include <atomic>
+#elif defined(MYSTL_PLATFORM_LINUX) || defined(MYSTL_PLATFORM_APPLE)
+#include <pthread.h>
+#define MYSTL_ALLOC_PTHREAD_LOCK
+#endif
+#ifdef MYSTL_PLATFORM_LINUX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #   define __THROW_BAD_ALLOC throw std::bad_alloc()
 
 
+// 定义 MYSTL_ALLOC_STATS 后, 配置器在分配/回收路径上更新统计计数器
+#ifdef MYSTL_ALLOC_STATS
+#   define __ALLOC_STAT(stmt) stmt
+#else
+#   define __ALLOC_STAT(stmt)
+#endif
+
+
 
 
 
@@ -20,6 +42,37 @@ namespace msl {
 
 
 
+/**
+ * @brief 配置器统计用的计数器
+ *
+ * 多线程下使用 relaxed 原子操作, 只保证计数不丢失, 不提供任何同步。
+ * 静态存储的计数器在程序启动前就被零初始化。
+ */
+struct alloc_counter {
+#if MYSTL_CPP_VERSION >= 11
+    std::atomic<size_t> value;
+    void add(size_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+    void sub(size_t n) { value.fetch_sub(n, std::memory_order_relaxed); }
+    size_t get() const { return value.load(std::memory_order_relaxed); }
+    void reset() { value.store(0, std::memory_order_relaxed); }
+#else
+    size_t value;
+    void add(size_t n) { value += n; }
+    void sub(size_t n) { value -= n; }
+    size_t get() const { return value; }
+    void reset() { value = 0; }
+#endif
+};
+
+
+// malloc_alloc_template::stats() 返回的快照
+struct malloc_alloc_stats {
+    size_t allocs;          // 累计 allocate 次数
+    size_t deallocs;        // 累计 deallocate 次数
+    size_t reallocs;        // 累计 reallocate 次数
+    size_t bytes_in_use;    // 按调用者传入的大小计算的在用字节数
+    size_t oom_retries;     // 调用 oom handler 的次数
+};
 
 
 class malloc_alloc_template {
@@ -29,24 +82,82 @@ private:
     static void* oom_realloc(void* p, size_t new_sz);
     static void (*__malloc_alloc_oom_handler)();
 
+    struct counters {
+        alloc_counter allocs;
+        alloc_counter deallocs;
+        alloc_counter reallocs;
+        alloc_counter bytes_in_use;
+        alloc_counter oom_retries;
+    };
+    // 局部静态变量只做零初始化, 不需要运行时的初始化检查
+    static counters& stat() {
+        static counters c;
+        return c;
+    }
+
 public:
 
     static void* allocate(size_t n) {
         void* p = malloc(n);
         if (!p) p = oom_malloc(n);
+        __ALLOC_STAT(stat().allocs.add(1));
+        __ALLOC_STAT(stat().bytes_in_use.add(n));
         return p;
     }
 
-    static void deallocate(void* p, size_t) {
+    static void deallocate(void* p, size_t n) {
         free(p);
+        __ALLOC_STAT(if (p) stat().deallocs.add(1));
+        __ALLOC_STAT(if (p) stat().bytes_in_use.sub(n));
+        (void)n;
     }
 
-    static void* reallocate(void* p, size_t, size_t new_sz) {
+    // 一次申请 count 个 n 字节的区块, 中途失败时归还已经申请到的区块
+    static void allocate_batch(size_t n, void** out, size_t count) {
+        size_t i = 0;
+        MYSTL_TRY {
+            for (; i < count; ++i) out[i] = allocate(n);
+        }
+        MYSTL_UNWIND(deallocate_batch(n, out, i));
+    }
+
+    static void deallocate_batch(size_t n, void** p, size_t count) {
+        for (size_t i = 0; i < count; ++i) deallocate(p[i], n);
+    }
+
+    static void* reallocate(void* p, size_t old_sz, size_t new_sz) {
         void* r = realloc(p, new_sz);
         if (!r) r = oom_realloc(p, new_sz);
+        __ALLOC_STAT(stat().reallocs.add(1));
+        __ALLOC_STAT(stat().bytes_in_use.add(new_sz));
+        __ALLOC_STAT(stat().bytes_in_use.sub(old_sz));
+        (void)old_sz;
         return r;
     }
 
+    /**
+     * @brief 返回统计计数器的快照
+     *
+     * 只有定义了 MYSTL_ALLOC_STATS 时计数器才会更新, 否则全部为 0。
+     */
+    static malloc_alloc_stats stats() {
+        malloc_alloc_stats s;
+        s.allocs = stat().allocs.get();
+        s.deallocs = stat().deallocs.get();
+        s.reallocs = stat().reallocs.get();
+        s.bytes_in_use = stat().bytes_in_use.get();
+        s.oom_retries = stat().oom_retries.get();
+        return s;
+    }
+
+    // 清零累计计数, bytes_in_use 反映的是当前状态, 不清零
+    static void reset_stats() {
+        stat().allocs.reset();
+        stat().deallocs.reset();
+        stat().reallocs.reset();
+        stat().oom_retries.reset();
+    }
+
     static void (*set_malloc_handler(void (*f)()))() {
         void (*old)() = __malloc_alloc_oom_handler;
         __malloc_alloc_oom_handler = f;
@@ -67,6 +178,7 @@ void* malloc_alloc_template::oom_malloc(size_t n) {
         handler = __malloc_alloc_oom_handler;
         if (!handler) __THROW_BAD_ALLOC;
         (*handler)();
+        __ALLOC_STAT(stat().oom_retries.add(1));
         ret = malloc(n);
         if (ret) return ret;
     }
@@ -80,6 +192,7 @@ void* malloc_alloc_template::oom_realloc(void* p, size_t new_sz) {
         handler = __malloc_alloc_oom_handler;
         if (!handler) __THROW_BAD_ALLOC;
         (*handler)();
+        __ALLOC_STAT(stat().oom_retries.add(1));
         ret = realloc(p, new_sz);
         if (ret) return ret;
     }
@@ -95,7 +208,131 @@ enum { MAX_BYTES = 128 };
 enum { NFREELISTS = MAX_BYTES / ALIGN };
 
 
+/**
+ * @brief default_alloc_template::stats() 返回的快照
+ *
+ * 计数类字段只有定义了 MYSTL_ALLOC_STATS 时才会更新; heap_size, pool_bytes,
+ * chunks 和 free_blocks 是生成快照时从内存池现场统计的, 总是有效。
+ */
+struct default_alloc_stats {
+    struct size_class {
+        size_t size;            // 区块大小
+        size_t allocs;          // 累计分配次数
+        size_t deallocs;        // 累计回收次数
+        size_t free_blocks;     // 中心空闲链表(加上当前线程缓存)上的区块数
+    };
+    size_class classes[NFREELISTS];
+    size_t large_allocs;        // 超过 MAX_BYTES, 转交一级配置器的分配次数
+    size_t large_deallocs;
+    size_t round_up_waste;      // 在用区块中因为 ROUND_UP 浪费的字节数
+    size_t refills;             // refill 次数(多线程版本为线程缓存的补充次数)
+    size_t chunk_allocs;        // chunk_alloc 调用次数
+    size_t system_allocs;       // 向系统申请新chunk的次数
+    size_t heap_size;           // 内存池向系统申请的总字节数
+    size_t pool_bytes;          // 内存池中尚未切分的字节数
+    size_t chunks;              // chunk 数量
+};
+
+
+
+/**
+ * @brief 内存池向系统申请chunk的来源
+ *
+ * allocate 申请至少 *bytes 字节, 可以把 *bytes 调大(例如按页或大页取整),
+ * 返回的地址至少按 ALIGN 对齐, 失败时返回 0; deallocate 收到的是 allocate
+ * 返回的地址和调整后的 *bytes。每个chunk记录自己的 deallocate, 所以切换
+ * 来源之后, 之前申请的chunk仍然能被 trim() 正确释放。
+ */
+struct chunk_source {
+    void* (*allocate)(size_t* bytes);
+    void (*deallocate)(void* p, size_t bytes);
+};
+
+inline void* __malloc_chunk_allocate(size_t* bytes) { return malloc(*bytes); }
+inline void __malloc_chunk_deallocate(void* p, size_t) { free(p); }
+
+// 默认的来源, 与原来一样直接使用 malloc
+inline chunk_source malloc_chunk_source() {
+    chunk_source s = { &__malloc_chunk_allocate, &__malloc_chunk_deallocate };
+    return s;
+}
+
+#ifdef MYSTL_PLATFORM_LINUX
+enum { HUGE_PAGE_SIZE = 2 * 1024 * 1024 };
+
+inline void* __mmap_chunk_allocate(size_t* bytes) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t n = (*bytes + page - 1) & ~(page - 1);
+    void* p = mmap(0, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return 0;
+    *bytes = n;
+    return p;
+}
+
+// 多映射一个大页, 再把首尾多余的部分还回去, 得到按 2MB 对齐的区间
+inline void* __huge_page_chunk_allocate(size_t* bytes) {
+    size_t n = (*bytes + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+    char* raw = (char*)mmap(0, n + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == (char*)MAP_FAILED) return 0;
+    char* p = (char*)(((size_t)raw + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1));
+    size_t head = p - raw;
+    if (head) munmap(raw, head);
+    if (head != HUGE_PAGE_SIZE) munmap(p + n, HUGE_PAGE_SIZE - head);
+#ifdef MADV_HUGEPAGE
+    madvise(p, n, MADV_HUGEPAGE);   // 内核关闭了透明大页时失败, 不影响使用
+#endif
+    *bytes = n;
+    return p;
+}
+
+inline void __mmap_chunk_deallocate(void* p, size_t bytes) { munmap(p, bytes); }
+#endif
+
+// 用 mmap 直接向内核申请按页对齐的chunk, 非 Linux 平台退化为 malloc
+inline chunk_source mmap_chunk_source() {
+#ifdef MYSTL_PLATFORM_LINUX
+    chunk_source s = { &__mmap_chunk_allocate, &__mmap_chunk_deallocate };
+    return s;
+#else
+    return malloc_chunk_source();
+#endif
+}
+
+/**
+ * @brief 按 2MB 对齐并建议内核使用透明大页的chunk来源
+ *
+ * 节点很多的 rb_tree / hashtable 遍历时 TLB 缺失明显减少。每个chunk至少
+ * 2MB, 适合节点数量很大的内存池; 非 Linux 平台退化为 malloc。
+ */
+inline chunk_source huge_page_chunk_source() {
+#ifdef MYSTL_PLATFORM_LINUX
+    chunk_source s = { &__huge_page_chunk_allocate, &__mmap_chunk_deallocate };
+    return s;
+#else
+    return malloc_chunk_source();
+#endif
+}
+
 
+
+/**
+ * @brief 二级配置器(内存池)
+ *
+ * threads == false 时与sgi的单线程版本一致, 所有状态都是普通的静态变量。
+ * threads == true 时每个线程持有一份私有的空闲链表缓存(thread_cache),
+ * 热路径上只操作本线程的链表, 不加锁; 本地链表为空时从中心内存池批量取回
+ * NOBJS 个区块, 本地链表过长时再批量归还给中心内存池, 只有这两步需要加锁。
+ *
+ * 内存池向系统申请的每一块内存(chunk)开头都有一个 chunk_header, 所有chunk串成
+ * 一条链表。trim() 统计每个chunk中空闲的字节数, 把完全空闲的chunk还给系统;
+ * set_trim_threshold() 设置高水位线后, 池子超过该大小且回收的字节足够多时会
+ * 自动调用 trim(), 使负载高峰过后占用的内存能够降下来。
+ *
+ * @tparam threads 是否支持多线程
+ * @tparam inst 用来区分不同的实例, 每个实例拥有独立的内存池
+ */
+template <bool threads, int inst>
 class default_alloc_template {
 private:
     union obj {
@@ -103,19 +340,151 @@ private:
         char client_data[1];
     };
 
+    enum { NOBJS = 20 };                 // 每次从内存池取出(或归还)的区块数
+    enum { CACHE_LIMIT = 2 * NOBJS };    // 线程缓存中每条链表的最大长度
+
+    // 每个chunk的头部, 大小是 ALIGN 的整数倍, 不影响后面区块的对齐
+    struct chunk_header {
+        chunk_header* next;
+        size_t size;        // 头部之后可用的字节数
+        void (*release)(void* p, size_t bytes);  // 申请该chunk的来源的 deallocate
+    };
+    enum { CHUNK_HEADER_SIZE = (sizeof(chunk_header) + ALIGN - 1) & ~(ALIGN - 1) };
+
     static obj* free_list[NFREELISTS];
     static char* start_free;
     static char* end_free;
     static size_t heap_size;
+    static chunk_header* chunk_list;
+    static size_t trim_threshold;       // 0 表示不自动trim
+    static size_t freed_since_trim;     // 上次trim之后归还到中心链表的字节数
+    static chunk_source source;
+
+    // 统计计数器, 下标 NFREELISTS 记录转交一级配置器的大区块
+    struct counters {
+        alloc_counter allocs[NFREELISTS + 1];
+        alloc_counter deallocs[NFREELISTS + 1];
+        alloc_counter round_up_waste;
+        alloc_counter refills;
+        alloc_counter chunk_allocs;
+        alloc_counter system_allocs;
+    };
+    static counters stat;
+
+#if MYSTL_CPP_VERSION >= 11
+    static std::mutex pool_mutex;
+
+    // 每个线程私有的空闲链表, 线程退出时把缓存的区块全部还给中心内存池。
+    // 主线程的 thread_local 先于静态对象析构, 之后全局容器释放的区块
+    // 经 cache_destroyed() 判断后直接走加锁的中心链表
+    struct thread_cache {
+        obj* free_list[NFREELISTS];
+        size_t count[NFREELISTS];
+
+        thread_cache() {
+            for (int i = 0; i < NFREELISTS; ++i) {
+                free_list[i] = 0;
+                count[i] = 0;
+            }
+        }
+        ~thread_cache() {
+            cache_destroyed() = true;
+            for (int i = 0; i < NFREELISTS; ++i) {
+                if (free_list[i]) release_to_pool(i, free_list[i], count[i]);
+            }
+        }
+    };
+
+    static thread_cache& local_cache() {
+        static thread_local thread_cache cache;
+        return cache;
+    }
+    // 平凡类型的 thread_local 没有析构, 在线程的整个生命期内都可以访问
+    static bool& cache_destroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+#elif defined(MYSTL_ALLOC_PTHREAD_LOCK)
+    static pthread_mutex_t pool_mutex;
+#endif
+
+    // 只有 threads == true 时才真正加锁; C++11 之前使用 pthread 互斥量,
+    // 两者都没有的平台上不能实例化线程安全的版本
+    class lock {
+    public:
+        lock() {
+#if MYSTL_CPP_VERSION >= 11
+            if (threads) pool_mutex.lock();
+#elif defined(MYSTL_ALLOC_PTHREAD_LOCK)
+            if (threads) pthread_mutex_lock(&pool_mutex);
+#else
+            typedef char threads_need_cpp11_or_pthreads[threads ? -1 : 1];
+#endif
+        }
+        ~lock() {
+#if MYSTL_CPP_VERSION >= 11
+            if (threads) pool_mutex.unlock();
+#elif defined(MYSTL_ALLOC_PTHREAD_LOCK)
+            if (threads) pthread_mutex_unlock(&pool_mutex);
+#endif
+        }
+    };
+
 private:
     static size_t ROUND_UP(size_t bytes) { return (bytes + ALIGN - 1) & ~(ALIGN - 1); }
     static size_t FREELIST_INDEX(size_t bytes) { return (bytes + ALIGN - 1) / ALIGN - 1; }
     static void* refill(size_t n);
     static char* chunk_alloc(size_t size, int& nobjs);
+#if MYSTL_CPP_VERSION >= 11
+    static void* refill_cache(thread_cache& tc, size_t n);
+    static void release_to_pool(size_t index, obj* first, size_t count);
+#endif
+    static size_t trim_nolock();
+    static void stat_alloc(size_t n, size_t count = 1) {
+        if (n > (size_t)MAX_BYTES) {
+            stat.allocs[NFREELISTS].add(count);
+            return;
+        }
+        stat.allocs[FREELIST_INDEX(n)].add(count);
+        stat.round_up_waste.add((ROUND_UP(n) - n) * count);
+    }
+    static void stat_dealloc(size_t n, size_t count = 1) {
+        if (n > (size_t)MAX_BYTES) {
+            stat.deallocs[NFREELISTS].add(count);
+            return;
+        }
+        stat.deallocs[FREELIST_INDEX(n)].add(count);
+        stat.round_up_waste.sub((ROUND_UP(n) - n) * count);
+    }
+    // 调用者负责加锁
+    static void note_freed(size_t bytes) {
+        freed_since_trim += bytes;
+        if (heap_size > trim_threshold && freed_since_trim > (heap_size >> 1)) {
+            trim_nolock();
+            freed_since_trim = 0;
+        }
+    }
 public:
+    /** @brief allocate(n) 实际占用的字节数 */
+    static size_t good_size(size_t n) { return n > (size_t)MAX_BYTES ? n : ROUND_UP(n); }
+
     static void* allocate(std::size_t n) {
+        __ALLOC_STAT(stat_alloc(n));
         if (n > MAX_BYTES) return malloc_alloc::allocate(n);
         size_t index = FREELIST_INDEX(n);
+#if MYSTL_CPP_VERSION >= 11
+        if (threads && !cache_destroyed()) {
+            thread_cache& tc = local_cache();
+            obj* result = tc.free_list[index];
+            if (result) {
+                tc.free_list[index] = result->free_list_link;
+                --tc.count[index];
+                return result;
+            }
+            return refill_cache(tc, ROUND_UP(n));
+        }
+#endif
+        lock guard;
         obj** my_list = free_list + index;
         obj* result = *my_list;
         if (result) { *my_list = result->free_list_link; return result; }
@@ -123,41 +492,214 @@ public:
     }
     static void deallocate(void* p, size_t n) {
         if (!p || n == 0) return;
+        __ALLOC_STAT(stat_dealloc(n));
         obj* q = (obj*)p;
         obj** my_free_list;
         if (n > (size_t)MAX_BYTES) {
             malloc_alloc::deallocate(p, n);
             return;
         }
-        my_free_list = free_list + FREELIST_INDEX(n);
+        size_t index = FREELIST_INDEX(n);
+#if MYSTL_CPP_VERSION >= 11
+        if (threads && !cache_destroyed()) {
+            thread_cache& tc = local_cache();
+            q->free_list_link = tc.free_list[index];
+            tc.free_list[index] = q;
+            if (++tc.count[index] > CACHE_LIMIT) {
+                // 把链表头部的 NOBJS 个区块还给中心内存池
+                obj* last = q;
+                for (int i = 1; i < NOBJS; ++i) last = last->free_list_link;
+                tc.free_list[index] = last->free_list_link;
+                tc.count[index] -= NOBJS;
+                last->free_list_link = 0;
+                release_to_pool(index, q, NOBJS);
+            }
+            return;
+        }
+#endif
+        lock guard;
+        my_free_list = free_list + index;
         q->free_list_link = *my_free_list;
         *my_free_list = q;
+        if (trim_threshold) note_freed(ROUND_UP(n));
     }
+    /**
+     * @brief 一次取出 count 个 n 字节的区块, 写入 out[0, count)
+     *
+     * 先取空闲链表上已有的区块, 不够时直接从 chunk_alloc 切出剩下的部分,
+     * 不经过 refill 逐个挂到空闲链表上; 多线程版本整个过程只加一次锁。
+     */
+    static void allocate_batch(size_t n, void** out, size_t count);
+
+    /**
+     * @brief 一次归还 count 个 n 字节的区块
+     *
+     * 先把区块串成一条链表, 再整体挂到空闲链表上。p 中不能有空指针。
+     */
+    static void deallocate_batch(size_t n, void** p, size_t count);
+
+    /**
+     * @brief 改变区块大小, 内容按位搬移
+     *
+     * 新旧大小都超过 MAX_BYTES 时交给 realloc: glibc 对 mmap 出来的大块内存
+     * 使用 mremap, 只修改页表而不复制数据; 其他情况经常能原地扩展。
+     * 落在同一个大小级别时直接返回 p, 否则从内存池重新分配并 memcpy。
+     */
     static void* reallocate(void* p, size_t old_sz, size_t new_sz) {
         if (old_sz > MAX_BYTES && new_sz > MAX_BYTES) return malloc_alloc::reallocate(p, old_sz, new_sz);
-        if (ROUND_UP(old_sz) == ROUND_UP(new_sz)) return p;
+        if (ROUND_UP(old_sz) == ROUND_UP(new_sz)) {
+            __ALLOC_STAT(stat_dealloc(old_sz));
+            __ALLOC_STAT(stat_alloc(new_sz));
+            return p;
+        }
         void* result = allocate(new_sz);
-        size_t copy_sz = old_sz < new_sz ? old_sz : new_sz;
-        unsigned char* r = (unsigned char*)result;
-        unsigned char* s = (unsigned char*)p;
-        for (size_t i = 0; i < copy_sz; ++i) r[i] = s[i];
+        memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
         deallocate(p, old_sz);
         return result;
     }
+
+    /**
+     * @brief 把完全空闲的chunk归还给系统
+     *
+     * 多线程版本会先把当前线程缓存的区块还给中心内存池; 其他线程缓存中的区块
+     * 仍然算作正在使用, 它们所在的chunk不会被释放。
+     *
+     * @return size_t 归还给系统的字节数
+     */
+    static size_t trim() {
+#if MYSTL_CPP_VERSION >= 11
+        if (threads && !cache_destroyed()) {
+            thread_cache& tc = local_cache();
+            for (int i = 0; i < NFREELISTS; ++i) {
+                if (tc.free_list[i]) release_to_pool(i, tc.free_list[i], tc.count[i]);
+                tc.free_list[i] = 0;
+                tc.count[i] = 0;
+            }
+        }
+#endif
+        lock guard;
+        freed_since_trim = 0;
+        return trim_nolock();
+    }
+
+    /**
+     * @brief 设置自动trim的高水位线
+     *
+     * 内存池大小超过 bytes, 并且自上次trim以来归还的字节数超过池子的一半时,
+     * 在回收路径上自动调用 trim()。
+     *
+     * @param bytes 高水位线, 0 表示关闭自动trim(默认)
+     * @return size_t 原来的高水位线
+     */
+    static size_t set_trim_threshold(size_t bytes) {
+        lock guard;
+        size_t old = trim_threshold;
+        trim_threshold = bytes;
+        return old;
+    }
+
+    /**
+     * @brief 设置内存池申请新chunk的来源
+     *
+     * @code
+     * msl::alloc::set_chunk_source(msl::huge_page_chunk_source());
+     * @endcode
+     *
+     * @return chunk_source 原来的来源
+     */
+    static chunk_source set_chunk_source(const chunk_source& s) {
+        lock guard;
+        chunk_source old = source;
+        source = s;
+        return old;
+    }
+
+    // 内存池当前向系统申请的字节数
+    static size_t pool_size() {
+        lock guard;
+        return heap_size;
+    }
+
+    /**
+     * @brief 返回统计信息的快照
+     *
+     * 需要遍历所有空闲链表, 开销与空闲区块数成正比, 不要在热路径上调用。
+     * 多线程版本只能看到中心内存池和当前线程的缓存, 其他线程缓存的区块
+     * 不计入 free_blocks。
+     */
+    static default_alloc_stats stats();
+
+    // 清零累计计数; round_up_waste 反映的是当前状态, 不清零
+    static void reset_stats() {
+        for (int i = 0; i <= NFREELISTS; ++i) {
+            stat.allocs[i].reset();
+            stat.deallocs[i].reset();
+        }
+        stat.refills.reset();
+        stat.chunk_allocs.reset();
+        stat.system_allocs.reset();
+    }
+
+    /**
+     * @brief 把每个大小级别的直方图输出到 out
+     *
+     * 每行一个大小级别: 区块大小, 累计分配/回收次数, 在用区块数, 空闲区块数,
+     * 以及按在用字节数缩放的柱状图。
+     */
+    static void dump_stats(FILE* out = stderr);
 };
 
 
-typename default_alloc_template::obj*
-    default_alloc_template::free_list[NFREELISTS] = { 0 };
+template <bool threads, int inst>
+typename default_alloc_template<threads, inst>::obj*
+    default_alloc_template<threads, inst>::free_list[NFREELISTS] = { 0 };
+
+template <bool threads, int inst>
+char* default_alloc_template<threads, inst>::start_free = 0;
 
-char* default_alloc_template::start_free = 0;
+template <bool threads, int inst>
+char* default_alloc_template<threads, inst>::end_free = 0;
 
-char* default_alloc_template::end_free = 0;
+template <bool threads, int inst>
+size_t default_alloc_template<threads, inst>::heap_size = 0;
 
-size_t default_alloc_template::heap_size = 0;
+template <bool threads, int inst>
+typename default_alloc_template<threads, inst>::chunk_header*
+    default_alloc_template<threads, inst>::chunk_list = 0;
+
+template <bool threads, int inst>
+size_t default_alloc_template<threads, inst>::trim_threshold = 0;
+
+template <bool threads, int inst>
+size_t default_alloc_template<threads, inst>::freed_since_trim = 0;
+
+template <bool threads, int inst>
+typename default_alloc_template<threads, inst>::counters
+    default_alloc_template<threads, inst>::stat;
+
+// 定义 MYSTL_ALLOC_HUGE_PAGES 后, 内存池默认从透明大页申请chunk。
+// 这里必须是常量初始化, 其他静态对象的构造函数可能已经在使用配置器。
+template <bool threads, int inst>
+chunk_source default_alloc_template<threads, inst>::source =
+#if defined(MYSTL_ALLOC_HUGE_PAGES) && defined(MYSTL_PLATFORM_LINUX)
+    { &__huge_page_chunk_allocate, &__mmap_chunk_deallocate };
+#else
+    { &__malloc_chunk_allocate, &__malloc_chunk_deallocate };
+#endif
+
+#if MYSTL_CPP_VERSION >= 11
+template <bool threads, int inst>
+std::mutex default_alloc_template<threads, inst>::pool_mutex;
+#elif defined(MYSTL_ALLOC_PTHREAD_LOCK)
+template <bool threads, int inst>
+pthread_mutex_t default_alloc_template<threads, inst>::pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
-void* default_alloc_template::refill(size_t n) {
-    int nobjs = 20;
+template <bool threads, int inst>
+void* default_alloc_template<threads, inst>::refill(size_t n) {
+    __ALLOC_STAT(stat.refills.add(1));
+    int nobjs = NOBJS;
+    __ALLOC_STAT(stat.chunk_allocs.add(1));
     char* chunk = chunk_alloc(n, nobjs);
     if (nobjs == 1) return (void*)chunk;
     size_t index = FREELIST_INDEX(n);
@@ -175,8 +717,144 @@ void* default_alloc_template::refill(size_t n) {
     return (void*)chunk;
 }
 
+#if MYSTL_CPP_VERSION >= 11
+/**
+ * @brief 线程缓存为空时, 从中心内存池批量取回区块
+ *
+ * 优先取中心空闲链表上已有的区块(最多 NOBJS 个), 中心链表为空时才从 chunk_alloc
+ * 切出新的区块; 切分工作在锁外完成, 因为这块内存已经只属于当前线程。
+ */
+template <bool threads, int inst>
+void* default_alloc_template<threads, inst>::refill_cache(thread_cache& tc, size_t n) {
+    __ALLOC_STAT(stat.refills.add(1));
+    size_t index = FREELIST_INDEX(n);
+    obj* result;
+    int nobjs = NOBJS;
+    char* chunk;
+    {
+        lock guard;
+        result = free_list[index];
+        if (result) {
+            obj* last = result;
+            size_t got = 1;
+            while (got < NOBJS && last->free_list_link) {
+                last = last->free_list_link;
+                ++got;
+            }
+            free_list[index] = last->free_list_link;
+            last->free_list_link = 0;
+            tc.free_list[index] = result->free_list_link;
+            tc.count[index] = got - 1;
+            return result;
+        }
+        __ALLOC_STAT(stat.chunk_allocs.add(1));
+        chunk = chunk_alloc(n, nobjs);
+    }
+    if (nobjs == 1) return (void*)chunk;
+    obj* current = (obj*)(chunk + n);
+    tc.free_list[index] = current;
+    for (int i = 2; i < nobjs; ++i) {
+        obj* next = (obj*)(chunk + i * n);
+        current->free_list_link = next;
+        current = next;
+    }
+    current->free_list_link = 0;
+    tc.count[index] = nobjs - 1;
+    return (void*)chunk;
+}
+
+// 把一条以 first 开头, 长度为 count 的链表整体挂回中心空闲链表
+template <bool threads, int inst>
+void default_alloc_template<threads, inst>::release_to_pool(size_t index, obj* first, size_t count) {
+    obj* last = first;
+    for (size_t i = 1; i < count; ++i) last = last->free_list_link;
+    lock guard;
+    last->free_list_link = free_list[index];
+    free_list[index] = first;
+    if (trim_threshold) note_freed(count * (index + 1) * ALIGN);
+}
+#endif
+
+
+template <bool threads, int inst>
+void default_alloc_template<threads, inst>::allocate_batch(size_t n, void** out, size_t count) {
+    if (count == 0) return;
+    __ALLOC_STAT(stat_alloc(n, count));
+    if (n > (size_t)MAX_BYTES) {
+        malloc_alloc::allocate_batch(n, out, count);
+        return;
+    }
+    size_t index = FREELIST_INDEX(n);
+    n = ROUND_UP(n);
+    size_t got = 0;
+    obj* p;
+#if MYSTL_CPP_VERSION >= 11
+    if (threads && !cache_destroyed()) {
+        thread_cache& tc = local_cache();
+        for (p = tc.free_list[index]; p && got < count; p = p->free_list_link) out[got++] = p;
+        tc.free_list[index] = p;
+        tc.count[index] -= got;
+        if (got == count) return;
+    }
+#endif
+    lock guard;
+    for (p = free_list[index]; p && got < count; p = p->free_list_link) out[got++] = p;
+    free_list[index] = p;
+    MYSTL_TRY {
+        while (got < count) {
+            int nobjs = (int)(count - got);
+            __ALLOC_STAT(stat.chunk_allocs.add(1));
+            char* chunk = chunk_alloc(n, nobjs);
+            for (int i = 0; i < nobjs; ++i) out[got++] = chunk + i * n;
+        }
+    }
+    MYSTL_CATCH_ALL {
+        // 已经取到的区块还给中心空闲链表, 这里已经持有锁, 不能调用 deallocate_batch
+        while (got > 0) {
+            obj* q = (obj*)out[--got];
+            q->free_list_link = free_list[index];
+            free_list[index] = q;
+        }
+        MYSTL_RETHROW;
+    }
+}
+
+template <bool threads, int inst>
+void default_alloc_template<threads, inst>::deallocate_batch(size_t n, void** p, size_t count) {
+    if (count == 0) return;
+    __ALLOC_STAT(stat_dealloc(n, count));
+    if (n > (size_t)MAX_BYTES) {
+        malloc_alloc::deallocate_batch(n, p, count);
+        return;
+    }
+    size_t index = FREELIST_INDEX(n);
+    for (size_t i = 0; i + 1 < count; ++i) ((obj*)p[i])->free_list_link = (obj*)p[i + 1];
+    obj* first = (obj*)p[0];
+    obj* last = (obj*)p[count - 1];
+#if MYSTL_CPP_VERSION >= 11
+    if (threads && !cache_destroyed()) {
+        thread_cache& tc = local_cache();
+        if (tc.count[index] + count <= CACHE_LIMIT) {
+            last->free_list_link = tc.free_list[index];
+            tc.free_list[index] = first;
+            tc.count[index] += count;
+        } else {
+            last->free_list_link = 0;
+            release_to_pool(index, first, count);
+        }
+        return;
+    }
+#endif
+    lock guard;
+    last->free_list_link = free_list[index];
+    free_list[index] = first;
+    if (trim_threshold) note_freed(count * ROUND_UP(n));
+}
 
-char* default_alloc_template::chunk_alloc(size_t size, int& nobjs) {
+
+// 调用者负责加锁(threads == true 时)
+template <bool threads, int inst>
+char* default_alloc_template<threads, inst>::chunk_alloc(size_t size, int& nobjs) {
     size_t total_bytes = size * nobjs;
     size_t bytes_left = end_free - start_free;
     char* result;
@@ -200,11 +878,13 @@ char* default_alloc_template::chunk_alloc(size_t size, int& nobjs) {
             *my_list = (obj*)start_free;
         }
         size_t bytes_to_get = 2 * total_bytes + ROUND_UP(heap_size >> 4);
-        start_free = (char*)malloc(bytes_to_get);
-        if (start_free == 0) {
-            int i;
+        size_t raw_bytes = CHUNK_HEADER_SIZE + bytes_to_get;
+        void (*release)(void*, size_t) = source.deallocate;
+        char* raw = (char*)source.allocate(&raw_bytes);
+        if (raw == 0) {
+            size_t i;
             obj** me_free_list, * p;
-            for (i = size; i <= MAX_BYTES; i += ALIGN) {
+            for (i = size; i <= (size_t)MAX_BYTES; i += ALIGN) {
                 me_free_list = free_list + FREELIST_INDEX(i);
                 p = *me_free_list;
                 if (p) {
@@ -215,46 +895,1160 @@ char* default_alloc_template::chunk_alloc(size_t size, int& nobjs) {
                 }
             }
             end_free = 0;
-            start_free = (char*)malloc_alloc::allocate(bytes_to_get);
+            raw_bytes = CHUNK_HEADER_SIZE + bytes_to_get;
+            raw = (char*)malloc_alloc::allocate(raw_bytes);
+            release = &__malloc_chunk_deallocate;
         }
+        // 来源可能多给了内存(按页取整), 多出来的部分同样放进内存池
+        bytes_to_get = (raw_bytes - CHUNK_HEADER_SIZE) & ~(size_t)(ALIGN - 1);
+        __ALLOC_STAT(stat.system_allocs.add(1));
+        chunk_header* h = (chunk_header*)raw;
+        h->size = bytes_to_get;
+        h->release = release;
+        h->next = chunk_list;
+        chunk_list = h;
+        start_free = raw + CHUNK_HEADER_SIZE;
         heap_size += bytes_to_get;
         end_free = start_free + bytes_to_get;
         return chunk_alloc(size, nobjs);
     }
 }
 
+// trim 时每个chunk的统计信息
+struct __chunk_usage {
+    char* begin;
+    char* end;
+    size_t free_bytes;
+    void* header;
+};
+
+// 返回包含 p 的chunk, chunks 按 begin 升序排列
+inline __chunk_usage* __find_chunk(__chunk_usage* chunks, size_t n, const void* p) {
+    const char* c = (const char*)p;
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (chunks[mid].begin <= c) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return 0;
+    __chunk_usage* u = chunks + lo - 1;
+    return c < u->end ? u : 0;
+}
+
+// 调用者负责加锁
+template <bool threads, int inst>
+size_t default_alloc_template<threads, inst>::trim_nolock() {
+    size_t nchunks = 0;
+    for (chunk_header* h = chunk_list; h; h = h->next) ++nchunks;
+    if (nchunks == 0) return 0;
+    __chunk_usage* chunks = (__chunk_usage*)malloc(nchunks * sizeof(__chunk_usage));
+    if (!chunks) return 0;
 
-typedef default_alloc_template default_alloc;
+    // 1. 按地址排序所有chunk(插入排序, chunk数量通常很少)
+    size_t n = 0;
+    for (chunk_header* h = chunk_list; h; h = h->next, ++n) {
+        __chunk_usage u;
+        u.begin = (char*)h + CHUNK_HEADER_SIZE;
+        u.end = u.begin + h->size;
+        u.free_bytes = 0;
+        u.header = h;
+        size_t j = n;
+        for (; j > 0 && chunks[j - 1].begin > u.begin; --j) chunks[j] = chunks[j - 1];
+        chunks[j] = u;
+    }
+
+    // 2. 统计每个chunk中空闲的字节: 空闲链表上的区块 + 内存池中尚未切分的部分
+    for (size_t i = 0; i < (size_t)NFREELISTS; ++i) {
+        for (obj* p = free_list[i]; p; p = p->free_list_link) {
+            __chunk_usage* u = __find_chunk(chunks, nchunks, p);
+            if (u) u->free_bytes += (i + 1) * ALIGN;
+        }
+    }
+    __chunk_usage* pool_chunk = 0;
+    if (start_free != end_free) {
+        pool_chunk = __find_chunk(chunks, nchunks, start_free);
+        if (pool_chunk) pool_chunk->free_bytes += end_free - start_free;
+    }
 
+    size_t releasable = 0;
+    for (size_t i = 0; i < nchunks; ++i) {
+        if (chunks[i].free_bytes == (size_t)(chunks[i].end - chunks[i].begin)) ++releasable;
+    }
+    if (releasable == 0) {
+        free(chunks);
+        return 0;
+    }
 
+    // 3. 把属于空闲chunk的区块从空闲链表中摘掉
+    for (size_t i = 0; i < (size_t)NFREELISTS; ++i) {
+        obj** link = free_list + i;
+        while (*link) {
+            __chunk_usage* u = __find_chunk(chunks, nchunks, *link);
+            if (u && u->free_bytes == (size_t)(u->end - u->begin))
+                *link = (*link)->free_list_link;
+            else
+                link = &(*link)->free_list_link;
+        }
+    }
+    if (pool_chunk && pool_chunk->free_bytes == (size_t)(pool_chunk->end - pool_chunk->begin))
+        start_free = end_free = 0;
 
-#ifndef USE_DEFAULT_ALLOC 
-typedef malloc_alloc alloc;
+    // 4. 从chunk链表中摘掉并释放
+    size_t released = 0;
+    chunk_header** link = &chunk_list;
+    while (*link) {
+        chunk_header* h = *link;
+        __chunk_usage* u = __find_chunk(chunks, nchunks, (char*)h + CHUNK_HEADER_SIZE);
+        if (u->free_bytes == h->size) {
+            *link = h->next;
+            released += h->size;
+            h->release(h, CHUNK_HEADER_SIZE + h->size);
+        } else {
+            link = &h->next;
+        }
+    }
+    heap_size -= released;
+    free(chunks);
+    return released;
+}
+
+template <bool threads, int inst>
+default_alloc_stats default_alloc_template<threads, inst>::stats() {
+    default_alloc_stats s;
+    for (int i = 0; i < NFREELISTS; ++i) {
+        s.classes[i].size = (i + 1) * ALIGN;
+        s.classes[i].allocs = stat.allocs[i].get();
+        s.classes[i].deallocs = stat.deallocs[i].get();
+        s.classes[i].free_blocks = 0;
+    }
+    s.large_allocs = stat.allocs[NFREELISTS].get();
+    s.large_deallocs = stat.deallocs[NFREELISTS].get();
+    s.round_up_waste = stat.round_up_waste.get();
+    s.refills = stat.refills.get();
+    s.chunk_allocs = stat.chunk_allocs.get();
+    s.system_allocs = stat.system_allocs.get();
+#if MYSTL_CPP_VERSION >= 11
+    if (threads && !cache_destroyed()) {
+        thread_cache& tc = local_cache();
+        for (int i = 0; i < NFREELISTS; ++i) s.classes[i].free_blocks += tc.count[i];
+    }
+#endif
+    lock guard;
+    for (int i = 0; i < NFREELISTS; ++i) {
+        for (obj* p = free_list[i]; p; p = p->free_list_link) ++s.classes[i].free_blocks;
+    }
+    s.heap_size = heap_size;
+    s.pool_bytes = end_free - start_free;
+    s.chunks = 0;
+    for (chunk_header* h = chunk_list; h; h = h->next) ++s.chunks;
+    return s;
+}
+
+template <bool threads, int inst>
+void default_alloc_template<threads, inst>::dump_stats(FILE* out) {
+    default_alloc_stats s = stats();
+    size_t max_bytes = 0;
+    for (int i = 0; i < NFREELISTS; ++i) {
+        const default_alloc_stats::size_class& c = s.classes[i];
+        size_t in_use = c.allocs > c.deallocs ? c.allocs - c.deallocs : 0;
+        if (in_use * c.size > max_bytes) max_bytes = in_use * c.size;
+    }
+    fprintf(out, "%6s %12s %12s %10s %8s\n", "size", "allocs", "deallocs", "in_use", "free");
+    for (int i = 0; i < NFREELISTS; ++i) {
+        const default_alloc_stats::size_class& c = s.classes[i];
+        size_t in_use = c.allocs > c.deallocs ? c.allocs - c.deallocs : 0;
+        if (c.allocs == 0 && c.free_blocks == 0) continue;
+        int bar = max_bytes ? (int)(in_use * c.size * 40 / max_bytes) : 0;
+        fprintf(out, "%6lu %12lu %12lu %10lu %8lu ", (unsigned long)c.size,
+                (unsigned long)c.allocs, (unsigned long)c.deallocs,
+                (unsigned long)in_use, (unsigned long)c.free_blocks);
+        for (int j = 0; j < bar; ++j) fputc('#', out);
+        fputc('\n', out);
+    }
+    fprintf(out, "%6s %12lu %12lu\n", ">max", (unsigned long)s.large_allocs,
+            (unsigned long)s.large_deallocs);
+    fprintf(out, "heap_size %lu, chunks %lu, pool_bytes %lu, round_up_waste %lu\n",
+            (unsigned long)s.heap_size, (unsigned long)s.chunks,
+            (unsigned long)s.pool_bytes, (unsigned long)s.round_up_waste);
+    fprintf(out, "refills %lu, chunk_allocs %lu, system_allocs %lu\n",
+            (unsigned long)s.refills, (unsigned long)s.chunk_allocs,
+            (unsigned long)s.system_allocs);
+}
+
+
+// 定义 MYSTL_THREADS 后, 默认配置器 alloc 变为线程安全的版本
+#ifdef MYSTL_THREADS
+#   define __NODE_ALLOCATOR_THREADS true
 #else
-typedef default_alloc alloc;
+#   define __NODE_ALLOCATOR_THREADS false
 #endif
 
+typedef default_alloc_template<__NODE_ALLOCATOR_THREADS, 0> default_alloc;
+typedef default_alloc_template<false, 0> single_client_alloc;
+#if MYSTL_CPP_VERSION >= 11
+typedef default_alloc_template<true, 0> thread_alloc;
+#endif
 
 
-template <typename T, typename Alloc>
-struct simple_alloc {
-    static T* allocate(size_t n) {
-        return n ? static_cast<T*>(Alloc::allocate(n * sizeof(T))) : 0;
+
+/**
+ * @brief 调试配置器, 检查越界写, 重复释放, 释放后写入和大小不匹配
+ *
+ * 每个区块前面有一个记录大小和状态的头部, 后面紧跟一个保护字:
+ *
+ *     | magic | size | 用户数据(n 字节) | guard |
+ *
+ * 新分配的区块填充 ALLOC_FILL, 释放的区块填充 FREE_FILL 后放进一个容量为
+ * QUARANTINE 的隔离区, 被挤出隔离区时才真正还给 Alloc, 这时再检查一遍填充
+ * 有没有被改写。deallocate 检查头部状态(重复释放), 传入的大小和保护字。
+ * 区块离开隔离区之后可能被复用, 所以更晚的重复释放不保证能发现。
+ *
+ * 发现错误时调用错误处理函数, 默认输出到 stderr 后 abort(); 处理函数返回时
+ * 出错的区块不会被释放。debug_alloc 是无状态的, 可以直接作为任何容器的
+ * Alloc 参数; 定义 MYSTL_DEBUG_ALLOC 后默认配置器 alloc 也会换成它。
+ *
+ * 头部占 16 字节, 用户数据的对齐与 Alloc 返回的地址相同: 基于 malloc_alloc 时
+ * 是 16 字节, 基于 default_alloc 时只有 8 字节(ALIGN)。需要 16 字节对齐时用
+ * debug_alloc<aligned_alloc<16> >。
+ *
+ * @tparam Alloc 实际分配内存的配置器
+ */
+template <typename Alloc>
+class debug_alloc {
+private:
+    enum { HEADER_SIZE = 16 };              // 不破坏 Alloc 本身不超过 16 字节的对齐
+    enum { GUARD_SIZE = sizeof(size_t) };
+    enum { EXTRA = HEADER_SIZE + GUARD_SIZE };
+    enum { QUARANTINE = 64 };
+    enum { ALLOC_FILL = 0xcd, FREE_FILL = 0xdd };
+
+    struct header {
+        size_t magic;
+        size_t size;
+    };
+    static const size_t LIVE_MAGIC = (size_t)0xa110ca7edUL;
+    static const size_t FREED_MAGIC = (size_t)0xdeadf7eedUL;
+    static const size_t GUARD = (size_t)0xfeedfacecafebeefULL;
+
+    struct quarantine_slot {
+        header* block;
+    };
+    static quarantine_slot quarantine[QUARANTINE];
+    static size_t quarantine_pos;
+    static void (*error_handler)(const char* msg, void* p, size_t n);
+#if MYSTL_CPP_VERSION >= 11
+    static std::mutex quarantine_mutex;
+#endif
+
+    static header* to_header(void* p) { return (header*)((char*)p - HEADER_SIZE); }
+    static char* to_user(header* h) { return (char*)h + HEADER_SIZE; }
+
+    static void report(const char* msg, void* p, size_t n) {
+        if (error_handler) {
+            error_handler(msg, p, n);
+            return;
+        }
+        fprintf(stderr, "msl::debug_alloc: %s (block %p, size %lu)\n", msg, p, (unsigned long)n);
+        abort();
     }
 
-    static T* allocate() {
-        return static_cast<T*>(Alloc::allocate(sizeof(T)));
+    static bool guard_ok(header* h) {
+        size_t g;
+        memcpy(&g, to_user(h) + h->size, sizeof(g));
+        return g == GUARD;
     }
 
-    static void deallocate(T* p, size_t n) {
-        if (!p || n == 0) return;
-        Alloc::deallocate(p, n * sizeof(T));
+    // 被挤出隔离区的区块: 检查填充是否完好, 然后还给 Alloc
+    static void release(header* h) {
+        const unsigned char* c = (const unsigned char*)to_user(h);
+        for (size_t i = 0; i < h->size; ++i) {
+            if (c[i] != FREE_FILL) {
+                report("write after free", to_user(h), h->size);
+                break;
+            }
+        }
+        Alloc::deallocate(h, h->size + EXTRA);
     }
 
-    static void deallocate(T* p) {
+public:
+    static void* allocate(size_t n) {
+        header* h = (header*)Alloc::allocate(n + EXTRA);
+        h->magic = LIVE_MAGIC;
+        h->size = n;
+        memset(to_user(h), ALLOC_FILL, n);
+        size_t g = GUARD;
+        memcpy(to_user(h) + n, &g, sizeof(g));
+        return to_user(h);
+    }
+
+    static void deallocate(void* p, size_t n) {
         if (!p) return;
-        Alloc::deallocate(p, sizeof(T));
+        header* h = to_header(p);
+        if (h->magic == FREED_MAGIC) {
+            report("double free", p, n);
+            return;
+        }
+        if (h->magic != LIVE_MAGIC) {
+            report("block not allocated by debug_alloc or header overwritten", p, n);
+            return;
+        }
+        if (h->size != n) {
+            report("size passed to deallocate does not match allocation", p, n);
+            return;
+        }
+        if (!guard_ok(h)) {
+            report("write past end of block", p, n);
+            return;
+        }
+        h->magic = FREED_MAGIC;
+        memset(p, FREE_FILL, n);
+        header* evicted;
+        {
+#if MYSTL_CPP_VERSION >= 11
+            std::lock_guard<std::mutex> guard(quarantine_mutex);
+#endif
+            evicted = quarantine[quarantine_pos].block;
+            quarantine[quarantine_pos].block = h;
+            quarantine_pos = (quarantine_pos + 1) % QUARANTINE;
+        }
+        if (evicted) release(evicted);
+    }
+
+    static void* reallocate(void* p, size_t old_sz, size_t new_sz) {
+        void* result = allocate(new_sz);
+        if (p) {
+            memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+            deallocate(p, old_sz);
+        }
+        return result;
+    }
+
+    static void allocate_batch(size_t n, void** out, size_t count) {
+        size_t i = 0;
+        MYSTL_TRY {
+            for (; i < count; ++i) out[i] = allocate(n);
+        }
+        MYSTL_UNWIND(deallocate_batch(n, out, i));
+    }
+
+    static void deallocate_batch(size_t n, void** p, size_t count) {
+        for (size_t i = 0; i < count; ++i) deallocate(p[i], n);
     }
+
+    // 检查并释放隔离区中的所有区块
+    static void flush_quarantine() {
+        for (size_t i = 0; i < (size_t)QUARANTINE; ++i) {
+            header* h;
+            {
+#if MYSTL_CPP_VERSION >= 11
+                std::lock_guard<std::mutex> guard(quarantine_mutex);
+#endif
+                h = quarantine[i].block;
+                quarantine[i].block = 0;
+            }
+            if (h) release(h);
+        }
+    }
+
+    /**
+     * @brief 设置发现错误时调用的函数
+     *
+     * @return 原来的处理函数, 0 表示默认行为(输出后 abort)
+     */
+    static void (*set_error_handler(void (*f)(const char*, void*, size_t)))(const char*, void*, size_t) {
+        void (*old)(const char*, void*, size_t) = error_handler;
+        error_handler = f;
+        return old;
+    }
+};
+
+template <typename Alloc>
+typename debug_alloc<Alloc>::quarantine_slot debug_alloc<Alloc>::quarantine[QUARANTINE];
+
+template <typename Alloc>
+size_t debug_alloc<Alloc>::quarantine_pos = 0;
+
+template <typename Alloc>
+void (*debug_alloc<Alloc>::error_handler)(const char*, void*, size_t) = 0;
+
+#if MYSTL_CPP_VERSION >= 11
+template <typename Alloc>
+std::mutex debug_alloc<Alloc>::quarantine_mutex;
+#endif
+
+
+
+#ifndef USE_DEFAULT_ALLOC 
+typedef malloc_alloc __base_alloc;
+#else
+typedef default_alloc __base_alloc;
+#endif
+
+// 定义 MYSTL_DEBUG_ALLOC 后, 所有使用默认配置器的容器都经过 debug_alloc 检查
+#ifdef MYSTL_DEBUG_ALLOC
+typedef debug_alloc<__base_alloc> alloc;
+#else
+typedef __base_alloc alloc;
+#endif
+
+
+
+// 编译期计算 log2(N), N 必须是2的幂
+template <size_t N>
+struct __static_log2 {
+    enum { value = 1 + __static_log2<N / 2>::value };
+};
+
+template <>
+struct __static_log2<1> {
+    enum { value = 0 };
+};
+
+// 运行期计算 floor(log2(n)), n > 0
+inline size_t __log2_floor(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll((unsigned long long)n);
+#else
+    size_t r = 0;
+    while (n >>= 1) ++r;
+    return r;
+#endif
+}
+
+// 按 align 对齐的内存, 原始指针保存在返回地址之前的一个字中
+inline void* __aligned_malloc(size_t n, size_t align) {
+    char* raw = (char*)malloc_alloc::allocate(n + align + sizeof(void*));
+    size_t addr = (size_t)(raw + sizeof(void*));
+    char* result = (char*)((addr + align - 1) & ~(align - 1));
+    ((void**)result)[-1] = raw;
+    return result;
+}
+
+inline void __aligned_free(void* p, size_t n, size_t align) {
+    if (p) malloc_alloc::deallocate(((void**)p)[-1], n + align + sizeof(void*));
+}
+
+
+
+/**
+ * @brief 按 Align 字节对齐的配置器
+ *
+ * 每个区块都直接向一级配置器申请, 多申请 Align 个字节用来对齐。通过
+ * simple_alloc<T, aligned_alloc<Align> > 分配时, 实际的对齐是 Align 和
+ * alignof(T) 中较大的一个, 所以 aligned_alloc<> 只保证 T 本身的对齐要求,
+ * aligned_alloc<64> 还能保证按缓存行对齐, 避免伪共享。
+ *
+ * @code
+ * msl::vector<float, msl::aligned_alloc<32> > v;   // v.data() 按 32 字节对齐
+ * @endcode
+ *
+ * @tparam Align 对齐字节数, 0 或 2 的幂
+ */
+template <size_t Align = 0>
+class aligned_alloc {
+#if MYSTL_CPP_VERSION >= 11
+    static_assert((Align & (Align - 1)) == 0, "Align must be 0 or a power of 2");
+#else
+    typedef char align_must_be_0_or_pow2[(Align & (Align - 1)) == 0 ? 1 : -1];
+#endif
+public:
+    // 直接按字节分配时的对齐, 至少与 malloc 一致
+    enum { alignment = Align > 2 * sizeof(void*) ? Align : 2 * sizeof(void*) };
+
+    static void* allocate(size_t n) { return __aligned_malloc(n, alignment); }
+
+    static void deallocate(void* p, size_t n) { __aligned_free(p, n, alignment); }
+
+    static void* reallocate(void* p, size_t old_sz, size_t new_sz) {
+        void* result = allocate(new_sz);
+        if (p) {
+            memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+            deallocate(p, old_sz);
+        }
+        return result;
+    }
+
+    static void allocate_batch(size_t n, void** out, size_t count) {
+        size_t i = 0;
+        MYSTL_TRY {
+            for (; i < count; ++i) out[i] = allocate(n);
+        }
+        MYSTL_UNWIND(deallocate_batch(n, out, i));
+    }
+
+    static void deallocate_batch(size_t n, void** p, size_t count) {
+        for (size_t i = 0; i < count; ++i) deallocate(p[i], n);
+    }
+};
+
+
+
+/**
+ * @brief 支持自定义对齐和更大尺寸的内存池
+ *
+ * default_alloc_template 只管理 8~128 字节, 按 8 字节对齐。pool_alloc_template 把
+ * 尺寸分为两段: 不超过 8 * Align 的请求按 Align 线性分级; 更大的请求按几何级数
+ * 分级, 每个 [2^k, 2^(k+1)) 区间分为 4 级。所有分级都是 Align 的整数倍, 内存池
+ * 的起始地址也按 Align 对齐, 所以每个区块都满足 Align 对齐。超过 MaxBytes 的请求
+ * 交给一级配置器, 同样按 Align 对齐。
+ *
+ * 例: Align = 16, MaxBytes = 4096 时的分级为
+ * 16, 32, ..., 128, 160, 192, 224, 256, 320, 384, 448, 512, ..., 3584, 4096
+ *
+ * @tparam Align 对齐字节数, 必须是2的幂且不小于 sizeof(void*)
+ * @tparam MaxBytes 内存池管理的最大尺寸, 必须是2的幂且大于 8 * Align
+ * @tparam inst 用来区分不同的实例, 每个实例拥有独立的内存池
+ */
+template <size_t Align, size_t MaxBytes, int inst>
+class pool_alloc_template {
+private:
+    union obj {
+        union obj* free_list_link;
+        char client_data[1];
+    };
+
+    enum { LINEAR_CLASSES = 8 };
+    enum { LINEAR_MAX = LINEAR_CLASSES * Align };
+    enum { LINEAR_SHIFT = __static_log2<LINEAR_MAX>::value };
+    enum { NCLASSES = LINEAR_CLASSES + 4 * (__static_log2<MaxBytes>::value - LINEAR_SHIFT) };
+    enum { REFILL_BYTES = 16 * 1024 }; // 一次refill大约切出的字节数
+
+#if MYSTL_CPP_VERSION >= 11
+    static_assert((Align & (Align - 1)) == 0 && Align >= sizeof(void*),
+                  "Align must be a power of two and at least sizeof(void*)");
+    static_assert((MaxBytes & (MaxBytes - 1)) == 0 && MaxBytes > LINEAR_MAX,
+                  "MaxBytes must be a power of two greater than 8 * Align");
+#else
+    // C++11 之前的 static_assert 宏只能用在函数体内
+    typedef char align_must_be_pow2_and_at_least_pointer_size[
+        (Align & (Align - 1)) == 0 && Align >= sizeof(void*) ? 1 : -1];
+    typedef char max_bytes_must_be_pow2_greater_than_8_align[
+        (MaxBytes & (MaxBytes - 1)) == 0 && MaxBytes > LINEAR_MAX ? 1 : -1];
+#endif
+
+    static obj* free_list[NCLASSES];
+    static char* start_free;
+    static char* end_free;
+    static size_t heap_size;
+
+private:
+    static size_t ROUND_UP(size_t bytes) { return (bytes + Align - 1) & ~(Align - 1); }
+
+    static size_t CLASS_INDEX(size_t bytes) {
+        if (bytes <= LINEAR_MAX) return (bytes + Align - 1) / Align - (bytes != 0);
+        size_t k = __log2_floor(bytes - 1);         // 2^k < bytes <= 2^(k+1)
+        size_t step = (size_t)1 << (k - 2);
+        size_t j = (bytes - ((size_t)1 << k) + step - 1) / step; // 1..4
+        return LINEAR_CLASSES + (k - LINEAR_SHIFT) * 4 + (j - 1);
+    }
+
+    static size_t CLASS_SIZE(size_t index) {
+        if (index < LINEAR_CLASSES) return (index + 1) * Align;
+        size_t g = index - LINEAR_CLASSES;
+        size_t k = LINEAR_SHIFT + g / 4;
+        return ((size_t)1 << k) + (g % 4 + 1) * ((size_t)1 << (k - 2));
+    }
+
+    static void push(size_t index, void* p) {
+        obj* q = (obj*)p;
+        q->free_list_link = free_list[index];
+        free_list[index] = q;
+    }
+
+    static void* refill(size_t index);
+    static char* chunk_alloc(size_t size, int& nobjs);
+
+public:
+    enum { alignment = Align };
+    enum { max_bytes = MaxBytes };
+
+    // 实际分配给 n 字节请求的字节数
+    static size_t good_size(size_t n) {
+        return n > MaxBytes ? n : CLASS_SIZE(CLASS_INDEX(n));
+    }
+
+    static void* allocate(size_t n) {
+        if (n > MaxBytes) return __aligned_malloc(n, Align);
+        size_t index = CLASS_INDEX(n);
+        obj* result = free_list[index];
+        if (result) {
+            free_list[index] = result->free_list_link;
+            return result;
+        }
+        return refill(index);
+    }
+
+    static void deallocate(void* p, size_t n) {
+        if (!p) return;
+        if (n > MaxBytes) {
+            __aligned_free(p, n, Align);
+            return;
+        }
+        push(CLASS_INDEX(n), p);
+    }
+
+    static void allocate_batch(size_t n, void** out, size_t count) {
+        size_t i = 0;
+        MYSTL_TRY {
+            for (; i < count; ++i) out[i] = allocate(n);
+        }
+        MYSTL_UNWIND(deallocate_batch(n, out, i));
+    }
+
+    static void deallocate_batch(size_t n, void** p, size_t count) {
+        for (size_t i = 0; i < count; ++i) deallocate(p[i], n);
+    }
+
+    static void* reallocate(void* p, size_t old_sz, size_t new_sz) {
+        if (old_sz <= MaxBytes && new_sz <= MaxBytes &&
+            CLASS_INDEX(old_sz) == CLASS_INDEX(new_sz))
+            return p;
+        void* result = allocate(new_sz);
+        memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+        deallocate(p, old_sz);
+        return result;
+    }
+};
+
+template <size_t Align, size_t MaxBytes, int inst>
+typename pool_alloc_template<Align, MaxBytes, inst>::obj*
+    pool_alloc_template<Align, MaxBytes, inst>::free_list[NCLASSES] = { 0 };
+
+template <size_t Align, size_t MaxBytes, int inst>
+char* pool_alloc_template<Align, MaxBytes, inst>::start_free = 0;
+
+template <size_t Align, size_t MaxBytes, int inst>
+char* pool_alloc_template<Align, MaxBytes, inst>::end_free = 0;
+
+template <size_t Align, size_t MaxBytes, int inst>
+size_t pool_alloc_template<Align, MaxBytes, inst>::heap_size = 0;
+
+template <size_t Align, size_t MaxBytes, int inst>
+void* pool_alloc_template<Align, MaxBytes, inst>::refill(size_t index) {
+    size_t n = CLASS_SIZE(index);
+    int nobjs = (int)(REFILL_BYTES / n);
+    if (nobjs > 20) nobjs = 20;
+    if (nobjs < 2) nobjs = 2;
+    char* chunk = chunk_alloc(n, nobjs);
+    // 倒序入链, 使链表头部是地址最低的区块
+    for (int i = nobjs - 1; i > 0; --i) push(index, chunk + i * n);
+    return chunk;
+}
+
+template <size_t Align, size_t MaxBytes, int inst>
+char* pool_alloc_template<Align, MaxBytes, inst>::chunk_alloc(size_t size, int& nobjs) {
+    size_t total_bytes = size * nobjs;
+    size_t bytes_left = end_free - start_free;
+    char* result;
+    if (bytes_left >= total_bytes) {
+        result = start_free;
+        start_free += total_bytes;
+        return result;
+    }
+    else if (bytes_left >= size) {
+        nobjs = (int)(bytes_left / size);
+        total_bytes = size * nobjs;
+        result = start_free;
+        start_free += total_bytes;
+        return result;
+    }
+    else {
+        // 剩余的零头不一定正好是某一级的大小, 按从大到小拆开放入各级空闲链表
+        while (bytes_left >= Align) {
+            size_t index = CLASS_INDEX(bytes_left);
+            if (CLASS_SIZE(index) > bytes_left) --index;
+            size_t sz = CLASS_SIZE(index);
+            push(index, start_free);
+            start_free += sz;
+            bytes_left -= sz;
+        }
+        size_t bytes_to_get = 2 * total_bytes + ROUND_UP(heap_size >> 4);
+        // 额外申请 Align 字节用来对齐内存池的起始地址, 内存池不归还给系统
+        char* raw = (char*)malloc(bytes_to_get + Align);
+        if (raw == 0) {
+            for (size_t index = CLASS_INDEX(size); index < (size_t)NCLASSES; ++index) {
+                obj* p = free_list[index];
+                if (p) {
+                    free_list[index] = p->free_list_link;
+                    start_free = (char*)p;
+                    end_free = start_free + CLASS_SIZE(index);
+                    return chunk_alloc(size, nobjs);
+                }
+            }
+            end_free = 0;
+            raw = (char*)malloc_alloc::allocate(bytes_to_get + Align);
+        }
+        start_free = (char*)(((size_t)raw + Align - 1) & ~(Align - 1));
+        heap_size += bytes_to_get;
+        end_free = start_free + bytes_to_get;
+        return chunk_alloc(size, nobjs);
+    }
+}
+
+typedef pool_alloc_template<16, 4096, 0> pool_alloc;
+
+
+
+/**
+ * @brief 单调增长的内存区(monotonic buffer)
+ *
+ * 按指针递增的方式切分内存, 单个区块的 deallocate 只有在它是最近一次分配时才会
+ * 回退指针, 其余情况什么也不做; release() 一次性释放所有向系统申请的内存块。
+ * 适合"一次请求内创建大量临时容器, 请求结束时整体释放"的场景。
+ *
+ * 可以用一块外部缓冲区(例如栈上的数组)作为第一块内存, 用完后再向系统申请,
+ * 每次申请的大小按 2 倍增长。arena 不可拷贝, 也不是线程安全的。
+ */
+class arena {
+private:
+    struct block {
+        block* next;
+        size_t size;
+    };
+    enum { ALIGN = 16 };
+    enum { BLOCK_HEADER_SIZE = (sizeof(block) + ALIGN - 1) & ~(ALIGN - 1) };
+
+    block* blocks_;         // 向系统申请的内存块链表
+    char* cur_;
+    char* end_;
+    char* block_begin_;     // 当前内存块的起始位置, 用于判断能否回退
+    char* initial_;         // 外部缓冲区
+    size_t initial_size_;
+    size_t next_size_;
+    size_t allocated_;      // 已经分配出去的字节数
+
+    static size_t ROUND_UP(size_t bytes) { return (bytes + ALIGN - 1) & ~(ALIGN - 1); }
+
+    arena(const arena&);
+    arena& operator=(const arena&);
+
+    void* allocate_slow(size_t n) {
+        size_t size = next_size_;
+        while (size < n) size *= 2;
+        next_size_ = size * 2;
+        block* b = (block*)malloc_alloc::allocate(BLOCK_HEADER_SIZE + size);
+        b->next = blocks_;
+        b->size = size;
+        blocks_ = b;
+        block_begin_ = (char*)b + BLOCK_HEADER_SIZE;
+        cur_ = block_begin_ + n;
+        end_ = block_begin_ + size;
+        allocated_ += n;
+        return block_begin_;
+    }
+
+    void reset_to_initial() {
+        cur_ = block_begin_ = initial_;
+        end_ = initial_ ? initial_ + initial_size_ : 0;
+    }
+
+public:
+    /**
+     * @param block_size 第一次向系统申请的内存块大小
+     */
+    explicit arena(size_t block_size = 4096)
+        : blocks_(0), cur_(0), end_(0), block_begin_(0), initial_(0), initial_size_(0),
+          next_size_(block_size ? ROUND_UP(block_size) : (size_t)ALIGN), allocated_(0) {}
+
+    /**
+     * @param buffer 外部缓冲区, 生命周期必须长于 arena
+     * @param size 缓冲区大小
+     */
+    arena(void* buffer, size_t size)
+        : blocks_(0), cur_(0), end_(0), block_begin_(0), initial_(0), initial_size_(0),
+          next_size_(ROUND_UP(size ? size : (size_t)ALIGN)), allocated_(0) {
+        // 对齐外部缓冲区的起始地址
+        char* b = (char*)(((size_t)buffer + ALIGN - 1) & ~(size_t)(ALIGN - 1));
+        size_t skip = b - (char*)buffer;
+        if (skip < size) {
+            initial_ = b;
+            initial_size_ = (size - skip) & ~(size_t)(ALIGN - 1);
+        }
+        reset_to_initial();
+    }
+
+    ~arena() { release(); }
+
+    void* allocate(size_t n) {
+        n = ROUND_UP(n ? n : 1);
+        if ((size_t)(end_ - cur_) >= n) {
+            void* result = cur_;
+            cur_ += n;
+            allocated_ += n;
+            return result;
+        }
+        return allocate_slow(n);
+    }
+
+    // 只有最近一次分配的区块才能被回收
+    void deallocate(void* p, size_t n) {
+        n = ROUND_UP(n ? n : 1);
+        char* c = (char*)p;
+        if (c >= block_begin_ && c + n == cur_) {
+            cur_ = c;
+            allocated_ -= n;
+        }
+    }
+
+    // 最近一次分配的区块可以原地扩大或缩小
+    void* reallocate(void* p, size_t old_sz, size_t new_sz) {
+        size_t old_n = ROUND_UP(old_sz ? old_sz : 1);
+        size_t new_n = ROUND_UP(new_sz ? new_sz : 1);
+        char* c = (char*)p;
+        if (c >= block_begin_ && c + old_n == cur_ && (size_t)(end_ - c) >= new_n) {
+            cur_ = c + new_n;
+            allocated_ = allocated_ - old_n + new_n;
+            return p;
+        }
+        if (new_n <= old_n) return p;
+        void* result = allocate(new_sz);
+        memcpy(result, p, old_sz);
+        return result;
+    }
+
+    /**
+     * @brief 释放所有内存块, O(内存块数量), 与分配过的区块数量无关
+     *
+     * 调用之后, 之前从 arena 分配的所有内存都失效。
+     */
+    void release() {
+        while (blocks_) {
+            block* next = blocks_->next;
+            malloc_alloc::deallocate(blocks_, BLOCK_HEADER_SIZE + blocks_->size);
+            blocks_ = next;
+        }
+        allocated_ = 0;
+        reset_to_initial();
+    }
+
+    // 已经分配出去(尚未回退)的字节数
+    size_t bytes_allocated() const { return allocated_; }
+};
+
+/**
+ * @brief 使用 arena 分配内存的配置器
+ *
+ * 与 malloc_alloc / default_alloc 不同, arena_alloc 是有状态的: 它保存一个指向
+ * arena 的指针, 容器会保存配置器实例。默认构造的 arena_alloc 不绑定 arena,
+ * 这时退化为 malloc_alloc。
+ *
+ * @code
+ * msl::arena a;
+ * msl::vector<int, msl::arena_alloc> v(a);
+ * msl::map<int, int, msl::less<int>, msl::arena_alloc> m(msl::less<int>(), a);
+ * @endcode
+ */
+class arena_alloc {
+private:
+    arena* arena_;
+public:
+    arena_alloc() : arena_(0) {}
+    arena_alloc(arena& a) : arena_(&a) {}
+
+    void* allocate(size_t n) const {
+        return arena_ ? arena_->allocate(n) : malloc_alloc::allocate(n);
+    }
+
+    void deallocate(void* p, size_t n) const {
+        if (arena_) arena_->deallocate(p, n);
+        else malloc_alloc::deallocate(p, n);
+    }
+
+    void allocate_batch(size_t n, void** out, size_t count) const {
+        if (!arena_) {
+            malloc_alloc::allocate_batch(n, out, count);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) out[i] = arena_->allocate(n);
+    }
+
+    // arena 只能回收最近一次分配的区块, 从后往前归还
+    void deallocate_batch(size_t n, void** p, size_t count) const {
+        if (!arena_) {
+            malloc_alloc::deallocate_batch(n, p, count);
+            return;
+        }
+        while (count > 0) arena_->deallocate(p[--count], n);
+    }
+
+    void* reallocate(void* p, size_t old_sz, size_t new_sz) const {
+        return arena_ ? arena_->reallocate(p, old_sz, new_sz)
+                      : malloc_alloc::reallocate(p, old_sz, new_sz);
+    }
+
+    arena* resource() const { return arena_; }
+
+    bool operator==(const arena_alloc& x) const { return arena_ == x.arena_; }
+    bool operator!=(const arena_alloc& x) const { return arena_ != x.arena_; }
+};
+
+
+
+/**
+ * @brief 容器中保存配置器实例的基类
+ *
+ * 无状态的配置器(malloc_alloc, default_alloc ...)是空类, 不占用任何空间,
+ * get_alloc() 直接返回一个临时对象; 有状态的配置器(arena_alloc)保存在这里。
+ */
+template <typename Alloc, bool = is_empty<Alloc>::value>
+class alloc_holder {
+public:
+    explicit alloc_holder(const Alloc& a) : alloc_(a) {}
+    const Alloc& get_alloc() const { return alloc_; }
+protected:
+    Alloc& mutable_alloc() { return alloc_; }
+    void swap_alloc(alloc_holder& x) {
+        Alloc tmp = alloc_;
+        alloc_ = x.alloc_;
+        x.alloc_ = tmp;
+    }
+private:
+    Alloc alloc_;
+};
+
+template <typename Alloc>
+class alloc_holder<Alloc, true> {
+public:
+    explicit alloc_holder(const Alloc&) {}
+    Alloc get_alloc() const { return Alloc(); }
+protected:
+    void swap_alloc(alloc_holder&) {}
+};
+
+
+
+/**
+ * @brief 查询配置器为 n 字节实际分配的大小
+ *
+ * 配置器提供静态的 good_size(n) 时返回它的结果, 否则返回 n; C++11 之前总是返回 n。
+ * vector_growth_size_class 用它把容量取整到配置器的大小级别。
+ */
+template <typename Alloc>
+struct alloc_good_size {
+#if MYSTL_CPP_VERSION >= 11
+private:
+    template <typename A>
+    static size_t dispatch(size_t n, decltype(A::good_size(size_t()))*) { return A::good_size(n); }
+    template <typename A>
+    static size_t dispatch(size_t n, ...) { return n; }
+public:
+    static size_t get(size_t n) { return dispatch<Alloc>(n, 0); }
+#else
+    // 没有 decltype 时无法检测 good_size, 不做取整
+    static size_t get(size_t n) { return n; }
+#endif
+};
+
+
+
+/**
+ * @brief 以元素个数为单位的配置器接口
+ *
+ * 不带配置器参数的版本直接调用 Alloc 的静态函数, 只适用于无状态的配置器;
+ * 带配置器参数的版本通过实例调用, 两种配置器都适用, 容器内部使用后者。
+ */
+template <typename T, typename Alloc>
+struct simple_alloc {
+    static T* allocate(size_t n) {
+        return n ? static_cast<T*>(Alloc::allocate(n * sizeof(T))) : 0;
+    }
+
+    static T* allocate() {
+        return static_cast<T*>(Alloc::allocate(sizeof(T)));
+    }
+
+    static void deallocate(T* p, size_t n) {
+        if (!p || n == 0) return;
+        Alloc::deallocate(p, n * sizeof(T));
+    }
+
+    static void deallocate(T* p) {
+        if (!p) return;
+        Alloc::deallocate(p, sizeof(T));
+    }
+
+    static T* allocate(const Alloc& a, size_t n) {
+        return n ? static_cast<T*>(a.allocate(n * sizeof(T))) : 0;
+    }
+
+    static T* allocate(const Alloc& a) {
+        return static_cast<T*>(a.allocate(sizeof(T)));
+    }
+
+    static void deallocate(const Alloc& a, T* p, size_t n) {
+        if (!p || n == 0) return;
+        a.deallocate(p, n * sizeof(T));
+    }
+
+    static void deallocate(const Alloc& a, T* p) {
+        if (!p) return;
+        a.deallocate(p, sizeof(T));
+    }
+
+    /**
+     * @brief 把 n 个元素的区块改为 new_n 个元素, 内容按位搬移
+     *
+     * 只能用于可以按位搬移的类型, 由调用者保证。
+     */
+    static T* reallocate(const Alloc& a, T* p, size_t n, size_t new_n) {
+        if (!p || n == 0) return allocate(a, new_n);
+        return static_cast<T*>(a.reallocate(p, n * sizeof(T), new_n * sizeof(T)));
+    }
+
+    static T* reallocate(T* p, size_t n, size_t new_n) {
+        if (!p || n == 0) return allocate(new_n);
+        return static_cast<T*>(Alloc::reallocate(p, n * sizeof(T), new_n * sizeof(T)));
+    }
+
+    // 一次申请 count 个对象大小的区块, 每个区块放一个 T
+    static void allocate_batch(const Alloc& a, T** out, size_t count) {
+        a.allocate_batch(sizeof(T), (void**)out, count);
+    }
+
+    static void deallocate_batch(const Alloc& a, T** p, size_t count) {
+        a.deallocate_batch(sizeof(T), (void**)p, count);
+    }
+
+    static void allocate_batch(T** out, size_t count) {
+        Alloc::allocate_batch(sizeof(T), (void**)out, count);
+    }
+
+    static void deallocate_batch(T** p, size_t count) {
+        Alloc::deallocate_batch(sizeof(T), (void**)p, count);
+    }
+};
+
+
+
+/**
+ * @brief aligned_alloc 的 simple_alloc, 按 max(Align, alignof(T)) 对齐
+ */
+template <typename T, size_t Align>
+struct simple_alloc<T, aligned_alloc<Align> > {
+private:
+    typedef aligned_alloc<Align> Alloc;
+    enum { A = (size_t)Alloc::alignment > (size_t)alignment_of<T>::value
+                   ? (size_t)Alloc::alignment : (size_t)alignment_of<T>::value };
+public:
+    enum { alignment = A };
+
+    static T* allocate(size_t n) {
+        return n ? static_cast<T*>(__aligned_malloc(n * sizeof(T), A)) : 0;
+    }
+
+    static T* allocate() { return allocate(1); }
+
+    static void deallocate(T* p, size_t n) {
+        if (!p || n == 0) return;
+        __aligned_free(p, n * sizeof(T), A);
+    }
+
+    static void deallocate(T* p) { deallocate(p, 1); }
+
+    static T* reallocate(T* p, size_t n, size_t new_n) {
+        T* result = allocate(new_n);
+        if (p && n) {
+            memcpy((void*)result, (const void*)p, (n < new_n ? n : new_n) * sizeof(T));
+            deallocate(p, n);
+        }
+        return result;
+    }
+
+    static void allocate_batch(T** out, size_t count) {
+        size_t i = 0;
+        MYSTL_TRY {
+            for (; i < count; ++i) out[i] = allocate(1);
+        }
+        MYSTL_UNWIND(deallocate_batch(out, i));
+    }
+
+    static void deallocate_batch(T** p, size_t count) {
+        for (size_t i = 0; i < count; ++i) deallocate(p[i], 1);
+    }
+
+    // aligned_alloc 是无状态的, 带实例参数的版本直接转发
+    static T* allocate(const Alloc&, size_t n) { return allocate(n); }
+    static T* allocate(const Alloc&) { return allocate(1); }
+    static void deallocate(const Alloc&, T* p, size_t n) { deallocate(p, n); }
+    static void deallocate(const Alloc&, T* p) { deallocate(p, 1); }
+    static T* reallocate(const Alloc&, T* p, size_t n, size_t new_n) { return reallocate(p, n, new_n); }
+    static void allocate_batch(const Alloc&, T** out, size_t count) { allocate_batch(out, count); }
+    static void deallocate_batch(const Alloc&, T** p, size_t count) { deallocate_batch(p, count); }
+};
+
+
+
+/**
+ * @brief 节点来源: 每次直接向配置器申请/归还一个节点
+ *
+ * 节点容器在单个元素的插入/删除路径上使用, 与 node_batch 接口相同。
+ */
+template <typename T, typename Alloc>
+class node_single {
+private:
+    Alloc alloc_;
+public:
+    explicit node_single(const Alloc& a) : alloc_(a) {}
+    T* get() { return simple_alloc<T, Alloc>::allocate(alloc_); }
+    void put(T* p) { simple_alloc<T, Alloc>::deallocate(alloc_, p); }
+};
+
+/**
+ * @brief 节点来源: 按批向配置器申请/归还节点
+ *
+ * 区间插入和 clear() 使用, 每 BATCH 个节点才调用一次 allocate_batch /
+ * deallocate_batch。析构时把没有用完的节点和收集到的节点一起归还。
+ *
+ * @tparam T 节点类型
+ * @tparam Alloc 配置器
+ */
+template <typename T, typename Alloc>
+class node_batch {
+public:
+    enum { BATCH = 32 };
+
+    /**
+     * @param a 配置器
+     * @param hint 预计需要的节点数, 0 表示未知; 避免为很短的区间申请整批节点
+     */
+    explicit node_batch(const Alloc& a, size_t hint = 0) : alloc_(a), count_(0), hint_(hint) {}
+    ~node_batch() { flush(); }
+
+    T* get() {
+        if (count_ == 0) {
+            size_t n = (hint_ && hint_ < (size_t)BATCH) ? hint_ : (size_t)BATCH;
+            hint_ = hint_ > n ? hint_ - n : 0;
+            simple_alloc<T, Alloc>::allocate_batch(alloc_, nodes_, n);
+            // 倒序存放, 按地址递增的顺序交出节点, 遍历时对缓存更友好
+            for (size_t i = 0, j = n - 1; i < j; ++i, --j) {
+                T* tmp = nodes_[i];
+                nodes_[i] = nodes_[j];
+                nodes_[j] = tmp;
+            }
+            count_ = n;
+        }
+        return nodes_[--count_];
+    }
+
+    void put(T* p) {
+        if (count_ == (size_t)BATCH) flush();
+        nodes_[count_++] = p;
+    }
+
+    void flush() {
+        if (count_) simple_alloc<T, Alloc>::deallocate_batch(alloc_, nodes_, count_);
+        count_ = 0;
+    }
+
+private:
+    node_batch(const node_batch&);
+    node_batch& operator=(const node_batch&);
+
+    Alloc alloc_;
+    T* nodes_[BATCH];
+    size_t count_;
+    size_t hint_;
 };
 
 
@@ -0,0 +1,601 @@
+#ifndef MYSTL_BVECTOR_H
+#define MYSTL_BVECTOR_H
+
+#include "stl_config.h"
+#include "stl_algobase.h"
+#include "stl_vector.h"
+#include <stdint.h>
+
+namespace msl {
+
+typedef uint64_t __bit_word;
+enum { __WORD_BIT = 64 };
+
+inline size_t __bit_popcount(__bit_word w) {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcountll(w));
+#else
+    size_t n = 0;
+    for (; w; w &= w - 1) ++n;
+    return n;
+#endif
+}
+
+// 低 n 位为 1 的掩码, 0 < n <= __WORD_BIT
+inline __bit_word __bit_low_mask(unsigned n) {
+    return n == (unsigned)__WORD_BIT ? ~__bit_word(0) : ((__bit_word(1) << n) - 1);
+}
+
+
+
+/**
+ * @brief vector<bool> 中单个位的代理引用
+ */
+struct __bit_reference {
+    __bit_word* p;
+    __bit_word mask;
+
+    __bit_reference(__bit_word* x, __bit_word y) : p(x), mask(y) {}
+
+    operator bool() const { return (*p & mask) != 0; }
+    __bit_reference& operator=(bool x) {
+        if (x) *p |= mask;
+        else *p &= ~mask;
+        return *this;
+    }
+    __bit_reference& operator=(const __bit_reference& x) { return *this = bool(x); }
+    bool operator==(const __bit_reference& x) const { return bool(*this) == bool(x); }
+    bool operator<(const __bit_reference& x) const { return !bool(*this) && bool(x); }
+    void flip() { *p ^= mask; }
+};
+
+inline void swap(__bit_reference x, __bit_reference y) {
+    bool tmp = x;
+    x = y;
+    y = tmp;
+}
+
+
+
+/**
+ * @brief 位迭代器的公共部分: 所在的字和字内偏移
+ */
+struct __bit_iterator_base {
+    __bit_word* p;
+    unsigned offset;
+
+    __bit_iterator_base(__bit_word* x, unsigned y) : p(x), offset(y) {}
+
+    void bump_up() {
+        if (offset++ == (unsigned)__WORD_BIT - 1) {
+            offset = 0;
+            ++p;
+        }
+    }
+    void bump_down() {
+        if (offset-- == 0) {
+            offset = (unsigned)__WORD_BIT - 1;
+            --p;
+        }
+    }
+    void incr(ptrdiff_t i) {
+        ptrdiff_t n = i + offset;
+        p += n / __WORD_BIT;
+        n = n % __WORD_BIT;
+        if (n < 0) {
+            n += __WORD_BIT;
+            --p;
+        }
+        offset = static_cast<unsigned>(n);
+    }
+
+    bool operator==(const __bit_iterator_base& i) const { return p == i.p && offset == i.offset; }
+    bool operator!=(const __bit_iterator_base& i) const { return !(*this == i); }
+    bool operator<(const __bit_iterator_base& i) const {
+        return p < i.p || (p == i.p && offset < i.offset);
+    }
+    bool operator>(const __bit_iterator_base& i) const { return i < *this; }
+    bool operator<=(const __bit_iterator_base& i) const { return !(i < *this); }
+    bool operator>=(const __bit_iterator_base& i) const { return !(*this < i); }
+};
+
+inline ptrdiff_t operator-(const __bit_iterator_base& x, const __bit_iterator_base& y) {
+    return __WORD_BIT * (x.p - y.p) + x.offset - y.offset;
+}
+
+struct __bit_iterator : public __bit_iterator_base {
+    typedef random_access_iterator_tag iterator_category;
+    typedef bool value_type;
+    typedef ptrdiff_t difference_type;
+    typedef __bit_reference reference;
+    typedef __bit_reference* pointer;
+    typedef __bit_iterator iterator;
+
+    __bit_iterator() : __bit_iterator_base(0, 0) {}
+    __bit_iterator(__bit_word* x, unsigned y) : __bit_iterator_base(x, y) {}
+
+    reference operator*() const { return reference(p, __bit_word(1) << offset); }
+    iterator& operator++() { bump_up(); return *this; }
+    iterator operator++(int) { iterator tmp = *this; bump_up(); return tmp; }
+    iterator& operator--() { bump_down(); return *this; }
+    iterator operator--(int) { iterator tmp = *this; bump_down(); return tmp; }
+    iterator& operator+=(difference_type i) { incr(i); return *this; }
+    iterator& operator-=(difference_type i) { incr(-i); return *this; }
+    iterator operator+(difference_type i) const { iterator tmp = *this; return tmp += i; }
+    iterator operator-(difference_type i) const { iterator tmp = *this; return tmp -= i; }
+    reference operator[](difference_type i) const { return *(*this + i); }
+};
+
+inline __bit_iterator operator+(ptrdiff_t n, const __bit_iterator& x) { return x + n; }
+
+struct __bit_const_iterator : public __bit_iterator_base {
+    typedef random_access_iterator_tag iterator_category;
+    typedef bool value_type;
+    typedef ptrdiff_t difference_type;
+    typedef bool reference;
+    typedef bool const_reference;
+    typedef const bool* pointer;
+    typedef __bit_const_iterator const_iterator;
+
+    __bit_const_iterator() : __bit_iterator_base(0, 0) {}
+    __bit_const_iterator(__bit_word* x, unsigned y) : __bit_iterator_base(x, y) {}
+    __bit_const_iterator(const __bit_iterator& x) : __bit_iterator_base(x.p, x.offset) {}
+
+    const_reference operator*() const { return (*p & (__bit_word(1) << offset)) != 0; }
+    const_iterator& operator++() { bump_up(); return *this; }
+    const_iterator operator++(int) { const_iterator tmp = *this; bump_up(); return tmp; }
+    const_iterator& operator--() { bump_down(); return *this; }
+    const_iterator operator--(int) { const_iterator tmp = *this; bump_down(); return tmp; }
+    const_iterator& operator+=(difference_type i) { incr(i); return *this; }
+    const_iterator& operator-=(difference_type i) { incr(-i); return *this; }
+    const_iterator operator+(difference_type i) const { const_iterator tmp = *this; return tmp += i; }
+    const_iterator operator-(difference_type i) const { const_iterator tmp = *this; return tmp -= i; }
+    const_reference operator[](difference_type i) const { return *(*this + i); }
+};
+
+inline __bit_const_iterator operator+(ptrdiff_t n, const __bit_const_iterator& x) { return x + n; }
+
+
+
+/**
+ * @brief 按位存储的 vector<bool>
+ *
+ * 每 64 个元素占用一个 64 位的字, operator[] 和迭代器返回代理引用 __bit_reference。
+ * 存储区总是从字的第 0 位开始, 扩容交给配置器的 reallocate 按字搬移。
+ * count, find, fill, flip 以及 &=, |=, ^= 按字处理, 不再逐位循环。
+ *
+ * @tparam Alloc 分配器类型
+ * @tparam Growth 扩容策略, 以字为单位计算
+ */
+template <typename Alloc, typename Growth>
+class vector<bool, Alloc, Growth> : protected alloc_holder<Alloc> {
+public:
+    typedef bool value_type;
+    typedef msl::size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef __bit_reference reference;
+    typedef bool const_reference;
+    typedef __bit_reference* pointer;
+    typedef const bool* const_pointer;
+    typedef __bit_iterator iterator;
+    typedef __bit_const_iterator const_iterator;
+    typedef msl::reverse_iterator<iterator> reverse_iterator;
+    typedef msl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef Alloc allocator_type;
+
+    allocator_type get_allocator() const { return this->get_alloc(); }
+
+protected:
+    typedef simple_alloc<__bit_word, Alloc> data_allocator;
+
+    iterator start_;
+    iterator finish_;
+    __bit_word* end_of_storage_;
+
+    static size_type words_for(size_type n) { return (n + __WORD_BIT - 1) / __WORD_BIT; }
+    size_type word_capacity() const { return end_of_storage_ - start_.p; }
+    size_type words_in_use() const { return words_for(size()); }
+
+    // 最后一个字中有效位的掩码, 没有不完整的字时为 0
+    __bit_word tail_mask() const {
+        return finish_.offset ? __bit_low_mask(finish_.offset) : 0;
+    }
+
+    void initialize(size_type n) {
+        const size_type words = words_for(n);
+        __bit_word* q = words ? data_allocator::allocate(this->get_alloc(), words) : 0;
+        start_ = iterator(q, 0);
+        end_of_storage_ = q + words;
+        finish_ = start_ + difference_type(n);
+    }
+
+    void deallocate() {
+        if (start_.p) data_allocator::deallocate(this->get_alloc(), start_.p, word_capacity());
+    }
+
+    // 按扩容策略计算至少容纳 required 位的新容量(以字为单位)
+    size_type recommend_words(size_type required) const {
+        if (required > max_size()) MYSTL_THROW(std::length_error("vector<bool>"));
+        const size_type need = words_for(required);
+        size_type n = Growth::next_capacity(words_in_use(), need, sizeof(__bit_word));
+        if (n < need) n = need;
+        if (Growth::round_to_size_class) {
+            size_type rounded = alloc_good_size<Alloc>::get(n * sizeof(__bit_word)) / sizeof(__bit_word);
+            if (rounded > n) n = rounded;
+        }
+        return n;
+    }
+
+    // 存储区扩大到 words 个字, 已有的位按字原样搬移
+    void grow_words(size_type words) {
+        const size_type n = size();
+        __bit_word* q = start_.p
+            ? data_allocator::reallocate(this->get_alloc(), start_.p, word_capacity(), words)
+            : data_allocator::allocate(this->get_alloc(), words);
+        start_ = iterator(q, 0);
+        finish_ = start_ + difference_type(n);
+        end_of_storage_ = q + words;
+    }
+
+    // 在 position 处空出 n 位, 容量必须足够
+    void open_gap(iterator position, size_type n) {
+        iterator old_finish = finish_;
+        finish_ += difference_type(n);
+        msl::copy_backward(position, old_finish, finish_);
+    }
+
+    void fill_words(__bit_word* first, __bit_word* last, bool x) {
+        for (; first != last; ++first) *first = x ? ~__bit_word(0) : 0;
+    }
+
+    // 把 [first, last) 中的位设为 x, 中间的整字直接赋值
+    void fill_bits(iterator first, iterator last, bool x) {
+        if (first.p == last.p) {
+            for (; first != last; ++first) *first = x;
+            return;
+        }
+        if (first.offset) {
+            const __bit_word m = ~__bit_low_mask(first.offset);
+            if (x) *first.p |= m;
+            else *first.p &= ~m;
+            first = iterator(first.p + 1, 0);
+        }
+        fill_words(first.p, last.p, x);
+        if (last.offset) {
+            const __bit_word m = __bit_low_mask(last.offset);
+            if (x) *last.p |= m;
+            else *last.p &= ~m;
+        }
+    }
+
+    template <typename InputIt>
+    void range_initialize(InputIt first, InputIt last, input_iterator_tag) {
+        initialize(0);
+        for (; first != last; ++first) push_back(*first);
+    }
+    template <typename ForwardIt>
+    void range_initialize(ForwardIt first, ForwardIt last, forward_iterator_tag) {
+        initialize(static_cast<size_type>(msl::distance(first, last)));
+        msl::copy(first, last, start_);
+    }
+
+    void copy_words(const vector& x) {
+        const size_type words = x.words_in_use();
+        if (words) memcpy(start_.p, x.start_.p, words * sizeof(__bit_word));
+    }
+
+    void check_same_size(const vector& x) const {
+        if (size() != x.size()) MYSTL_THROW(std::invalid_argument("vector<bool>: size mismatch"));
+    }
+
+public:
+    vector(const allocator_type& a = allocator_type()) : alloc_holder<Alloc>(a) { initialize(0); }
+
+    explicit vector(size_type n, const allocator_type& a = allocator_type()) : alloc_holder<Alloc>(a) {
+        initialize(n);
+        fill_words(start_.p, end_of_storage_, false);
+    }
+
+    vector(size_type n, bool value, const allocator_type& a = allocator_type()) : alloc_holder<Alloc>(a) {
+        initialize(n);
+        fill_words(start_.p, end_of_storage_, value);
+    }
+
+    template <typename InputIt,typename = typename msl::enable_if<!msl::is_integer<InputIt>::Integral::value>::type>
+    vector(InputIt first, InputIt last, const allocator_type& a = allocator_type()) : alloc_holder<Alloc>(a) {
+        typedef typename msl::iterator_traits<InputIt>::iterator_category Cat;
+        range_initialize(first, last, Cat());
+    }
+
+#if MYSTL_CPP_VERSION >= 11
+    vector(std::initializer_list<bool> ilist, const allocator_type& a = allocator_type())
+        : alloc_holder<Alloc>(a) {
+        range_initialize(ilist.begin(), ilist.end(), forward_iterator_tag());
+    }
+#endif
+
+    vector(const vector& x) : alloc_holder<Alloc>(x.get_alloc()) {
+        initialize(x.size());
+        copy_words(x);
+    }
+
+#ifdef MYSTL_HAS_MOVE_SEMANTICS
+    vector(vector&& x) noexcept : alloc_holder<Alloc>(x.get_alloc()),
+        start_(x.start_), finish_(x.finish_), end_of_storage_(x.end_of_storage_) {
+        x.start_ = x.finish_ = iterator();
+        x.end_of_storage_ = 0;
+    }
+
+    vector& operator=(vector&& x) noexcept {
+        if (this != &x) {
+            deallocate();
+            start_ = x.start_;
+            finish_ = x.finish_;
+            end_of_storage_ = x.end_of_storage_;
+            x.start_ = x.finish_ = iterator();
+            x.end_of_storage_ = 0;
+            this->swap_alloc(x);
+        }
+        return *this;
+    }
+#endif
+
+    vector& operator=(const vector& x) {
+        if (this == &x) return *this;
+        if (x.size() > capacity()) {
+            deallocate();
+            initialize(x.size());
+        } else {
+            finish_ = start_ + difference_type(x.size());
+        }
+        copy_words(x);
+        return *this;
+    }
+
+    ~vector() { deallocate(); }
+
+    iterator begin() { return start_; }
+    const_iterator begin() const { return start_; }
+    iterator end() { return finish_; }
+    const_iterator end() const { return finish_; }
+    const_iterator cbegin() const { return start_; }
+    const_iterator cend() const { return finish_; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    size_type size() const { return size_type(finish_ - start_); }
+    size_type max_size() const { return size_type(-1) / 2; }
+    size_type capacity() const { return word_capacity() * __WORD_BIT; }
+    bool empty() const { return start_ == finish_; }
+
+    reference operator[](size_type n) { return *(start_ + difference_type(n)); }
+    const_reference operator[](size_type n) const { return *(const_iterator(start_) + difference_type(n)); }
+    reference at(size_type n) {
+        if (n >= size()) MYSTL_THROW(std::out_of_range("Index out of range"));
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        if (n >= size()) MYSTL_THROW(std::out_of_range("Index out of range"));
+        return (*this)[n];
+    }
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return *(end() - 1); }
+    const_reference back() const { return *(end() - 1); }
+
+    void reserve(size_type n) {
+        if (n > capacity()) {
+            if (n > max_size()) MYSTL_THROW(std::length_error("vector<bool>::reserve"));
+            grow_words(words_for(n));
+        }
+    }
+
+    void push_back(bool x) {
+        if (finish_.p == end_of_storage_) grow_words(recommend_words(size() + 1));
+        *finish_ = x;
+        ++finish_;
+    }
+    void pop_back() { --finish_; }
+
+    iterator insert(iterator position, bool x) {
+        const difference_type index = position - start_;
+        if (finish_.p == end_of_storage_) grow_words(recommend_words(size() + 1));
+        position = start_ + index;
+        open_gap(position, 1);
+        *position = x;
+        return position;
+    }
+
+    void insert(iterator position, size_type n, bool x) {
+        if (n == 0) return;
+        const difference_type index = position - start_;
+        if (size() + n > capacity()) grow_words(recommend_words(size() + n));
+        position = start_ + index;
+        open_gap(position, n);
+        fill_bits(position, position + difference_type(n), x);
+    }
+
+    template <typename InputIt,typename = typename msl::enable_if<!msl::is_integer<InputIt>::Integral::value>::type>
+    void insert(iterator position, InputIt first, InputIt last) {
+        typedef typename msl::iterator_traits<InputIt>::iterator_category Cat;
+        range_insert(position, first, last, Cat());
+    }
+
+#if MYSTL_CPP_VERSION >= 11
+    void insert(iterator position, std::initializer_list<bool> ilist) {
+        range_insert(position, ilist.begin(), ilist.end(), forward_iterator_tag());
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) { push_back(bool(msl::forward<Args>(args)...)); }
+#endif
+
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last) { insert(end(), first, last); }
+    template <typename Range>
+    void append_range(const Range& r) { insert(end(), r.begin(), r.end()); }
+
+    iterator erase(iterator position) {
+        if (position + 1 != end()) msl::copy(position + 1, end(), position);
+        --finish_;
+        return position;
+    }
+    iterator erase(iterator first, iterator last) {
+        finish_ = msl::copy(last, end(), first);
+        return first;
+    }
+
+    void resize(size_type new_size, bool x = false) {
+        if (new_size < size()) erase(begin() + difference_type(new_size), end());
+        else insert(end(), new_size - size(), x);
+    }
+
+    void assign(size_type n, bool x) {
+        clear();
+        insert(end(), n, x);
+    }
+    template <typename InputIt,typename = typename msl::enable_if<!msl::is_integer<InputIt>::Integral::value>::type>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        insert(end(), first, last);
+    }
+
+    void clear() { finish_ = start_; }
+
+    void swap(vector& x) {
+        msl::swap(start_, x.start_);
+        msl::swap(finish_, x.finish_);
+        msl::swap(end_of_storage_, x.end_of_storage_);
+        this->swap_alloc(x);
+    }
+
+    void shrink_to_fit() {
+        const size_type words = words_in_use();
+        if (words == word_capacity()) return;
+        if (words == 0) {
+            deallocate();
+            initialize(0);
+            return;
+        }
+        const size_type n = size();
+        __bit_word* q = data_allocator::reallocate(this->get_alloc(), start_.p, word_capacity(), words);
+        start_ = iterator(q, 0);
+        finish_ = start_ + difference_type(n);
+        end_of_storage_ = q + words;
+    }
+
+    // ---- 按字处理的算法 ----
+
+    /**
+     * @brief 统计值为 value 的元素个数, 每次处理一个字(popcount)
+     */
+    size_type count(bool value = true) const {
+        const __bit_word* p = start_.p;
+        const __bit_word* full_end = finish_.p;
+        size_type n = 0;
+        for (; p != full_end; ++p) n += __bit_popcount(*p);
+        if (finish_.offset) n += __bit_popcount(*p & tail_mask());
+        return value ? n : size() - n;
+    }
+
+    /**
+     * @brief 查找第一个值为 value 的元素, 跳过全 0 (或全 1) 的字
+     *
+     * @return const_iterator 找不到时返回 end()
+     */
+    const_iterator find(bool value) const {
+        const __bit_word flip_mask = value ? 0 : ~__bit_word(0);
+        __bit_word* p = start_.p;
+        for (; p != finish_.p; ++p) {
+            const __bit_word w = *p ^ flip_mask;
+            if (w) return const_iterator(p, __bit_ctz(w));
+        }
+        if (finish_.offset) {
+            const __bit_word w = (*p ^ flip_mask) & tail_mask();
+            if (w) return const_iterator(p, __bit_ctz(w));
+        }
+        return end();
+    }
+    iterator find(bool value) {
+        const_iterator i = static_cast<const vector&>(*this).find(value);
+        return iterator(i.p, i.offset);
+    }
+
+    /**
+     * @brief 把所有元素设为 value
+     */
+    void fill(bool value) { fill_words(start_.p, start_.p + words_in_use(), value); }
+
+    /**
+     * @brief 把所有元素取反
+     */
+    void flip() {
+        for (__bit_word* p = start_.p, *e = start_.p + words_in_use(); p != e; ++p) *p = ~*p;
+    }
+
+    /**
+     * @brief 逐字按位与, 两者长度必须相同
+     * @throws std::invalid_argument 长度不同
+     */
+    vector& operator&=(const vector& x) {
+        check_same_size(x);
+        for (size_type i = 0, n = words_in_use(); i != n; ++i) start_.p[i] &= x.start_.p[i];
+        return *this;
+    }
+    vector& operator|=(const vector& x) {
+        check_same_size(x);
+        for (size_type i = 0, n = words_in_use(); i != n; ++i) start_.p[i] |= x.start_.p[i];
+        return *this;
+    }
+    vector& operator^=(const vector& x) {
+        check_same_size(x);
+        for (size_type i = 0, n = words_in_use(); i != n; ++i) start_.p[i] ^= x.start_.p[i];
+        return *this;
+    }
+
+    /**
+     * @brief 内容是否相同, 整字比较, 最后一个不完整的字只比较有效位
+     */
+    bool equals(const vector& x) const {
+        if (size() != x.size()) return false;
+        const size_type full = finish_.p - start_.p;
+        if (full && memcmp(start_.p, x.start_.p, full * sizeof(__bit_word)) != 0) return false;
+        return !finish_.offset || ((start_.p[full] ^ x.start_.p[full]) & tail_mask()) == 0;
+    }
+
+private:
+    template <typename InputIt>
+    void range_insert(iterator position, InputIt first, InputIt last, input_iterator_tag) {
+        for (; first != last; ++first) {
+            position = insert(position, bool(*first));
+            ++position;
+        }
+    }
+
+    template <typename ForwardIt>
+    void range_insert(iterator position, ForwardIt first, ForwardIt last, forward_iterator_tag) {
+        const size_type n = static_cast<size_type>(msl::distance(first, last));
+        if (n == 0) return;
+        const difference_type index = position - start_;
+        if (size() + n > capacity()) grow_words(recommend_words(size() + n));
+        position = start_ + index;
+        open_gap(position, n);
+        for (; first != last; ++first, ++position) *position = bool(*first);
+    }
+};
+
+template <typename Alloc, typename Growth>
+inline bool operator==(const vector<bool, Alloc, Growth>& x, const vector<bool, Alloc, Growth>& y) {
+    return x.equals(y);
+}
+
+template <typename Alloc, typename Growth>
+inline bool operator!=(const vector<bool, Alloc, Growth>& x, const vector<bool, Alloc, Growth>& y) {
+    return !x.equals(y);
+}
+
+} // namespace msl
+
+#endif // MYSTL_BVECTOR_H
@@ -0,0 +1,393 @@
+#ifndef MYSTL_CHUNKED_VECTOR_H
+#define MYSTL_CHUNKED_VECTOR_H
+
+#include "stl_config.h"
+#include "stl_vector.h"
+
+namespace msl {
+
+// ChunkSize 为 0 时每块约 4096 字节, 向下取整到2的幂, 至少1个元素
+template <size_t Size, size_t ChunkSize>
+struct __chunked_vector_shift {
+    enum { value = __static_log2<ChunkSize>::value };
+    static_assert((ChunkSize & (ChunkSize - 1)) == 0, "chunked_vector chunk size must be a power of two");
+};
+
+template <size_t Size>
+struct __chunked_vector_shift<Size, 0> {
+    enum { value = __static_log2<(Size < 4096 ? 4096 / Size : 1)>::value };
+};
+
+
+
+/**
+ * @brief chunked_vector 的迭代器, 用下标和块表定位元素
+ *
+ * 块表可能随 push_back 重新分配, 所以迭代器会失效; 元素本身从不移动。
+ */
+template <typename T, typename Ref, typename Ptr, size_t Shift>
+struct __chunked_iterator {
+    typedef __chunked_iterator<T, T&, T*, Shift>              iterator;
+    typedef __chunked_iterator<T, const T&, const T*, Shift>  const_iterator;
+    typedef __chunked_iterator<T, Ref, Ptr, Shift>            self;
+
+    typedef random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    enum { MASK = (size_t(1) << Shift) - 1 };
+
+    T* const* map;
+    size_type index;
+
+    __chunked_iterator() : map(0), index(0) {}
+    __chunked_iterator(T* const* m, size_type i) : map(m), index(i) {}
+    __chunked_iterator(const iterator& x) : map(x.map), index(x.index) {}
+
+    reference operator*() const { return map[index >> Shift][index & MASK]; }
+    pointer operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    self& operator++() { ++index; return *this; }
+    self operator++(int) { self tmp = *this; ++index; return tmp; }
+    self& operator--() { --index; return *this; }
+    self operator--(int) { self tmp = *this; --index; return tmp; }
+    self& operator+=(difference_type n) { index += n; return *this; }
+    self& operator-=(difference_type n) { index -= n; return *this; }
+    self operator+(difference_type n) const { return self(map, index + n); }
+    self operator-(difference_type n) const { return self(map, index - n); }
+    difference_type operator-(const self& x) const { return difference_type(index - x.index); }
+
+    bool operator==(const self& x) const { return index == x.index; }
+    bool operator!=(const self& x) const { return index != x.index; }
+    bool operator<(const self& x) const { return index < x.index; }
+    bool operator>(const self& x) const { return index > x.index; }
+    bool operator<=(const self& x) const { return index <= x.index; }
+    bool operator>=(const self& x) const { return index >= x.index; }
+
+    // 当前元素所在块中, 从当前元素到块尾(不超过 last)的连续区间
+    Ptr segment_end(const self& last) const {
+        size_type n = (index | MASK) + 1;
+        if (n > last.index) n = last.index;
+        return &map[index >> Shift][index & MASK] + (n - index);
+    }
+};
+
+
+
+/**
+ * @brief 分块存储的 vector
+ *
+ * 元素存放在若干个大小为 2 的幂的块中, 块表(vector<T*>)记录每一块的地址:
+ * 下标 i 对应 chunk[i >> Shift][i & MASK], 随机访问只需要一次移位和一次掩码。
+ *
+ * 扩容只分配新的块并在块表末尾追加一个指针, 已有元素从不移动, 元素的引用和
+ * 指针始终有效(迭代器保存的是块表地址, 块表扩容后迭代器失效)。没有大块
+ * 内存的复制, 也不会短暂地同时持有新旧两份存储区。
+ *
+ * for_each 和 copy 对它的迭代器有按块处理的重载, 每块内部就是普通数组。
+ *
+ * @tparam T 元素类型
+ * @tparam ChunkSize 每块的元素个数, 必须是2的幂; 0 表示每块约 4096 字节
+ * @tparam Alloc 分配器类型，默认为 alloc
+ */
+template <typename T, size_t ChunkSize = 0, typename Alloc = alloc>
+class chunked_vector {
+public:
+    enum { SHIFT = __chunked_vector_shift<sizeof(T), ChunkSize>::value };
+    enum { CHUNK_SIZE = size_t(1) << SHIFT };
+
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef msl::size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef __chunked_iterator<T, T&, T*, SHIFT> iterator;
+    typedef __chunked_iterator<T, const T&, const T*, SHIFT> const_iterator;
+    typedef msl::reverse_iterator<iterator> reverse_iterator;
+    typedef msl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef Alloc allocator_type;
+
+private:
+    typedef simple_alloc<T, Alloc> data_allocator;
+    enum { MASK = CHUNK_SIZE - 1 };
+
+    vector<T*, Alloc> chunks_;
+    size_type size_;
+
+    T* slot(size_type i) const { return chunks_[i >> SHIFT] + (i & MASK); }
+
+    void add_chunk() {
+        T* chunk = data_allocator::allocate(chunks_.get_allocator(), CHUNK_SIZE);
+        MYSTL_TRY {
+            chunks_.push_back(chunk);
+        }
+        MYSTL_CATCH_ALL {
+            data_allocator::deallocate(chunks_.get_allocator(), chunk, CHUNK_SIZE);
+            MYSTL_RETHROW;
+        }
+    }
+
+    // 只保留前 keep 块, 其余的块归还配置器
+    void release_chunks(size_type keep) {
+        while (chunks_.size() > keep) {
+            data_allocator::deallocate(chunks_.get_allocator(), chunks_.back(), CHUNK_SIZE);
+            chunks_.pop_back();
+        }
+    }
+
+    static size_type chunks_for(size_type n) { return (n + MASK) >> SHIFT; }
+
+public:
+    chunked_vector(const allocator_type& a = allocator_type()) : chunks_(a), size_(0) {}
+
+    chunked_vector(size_type n, const_reference value, const allocator_type& a = allocator_type())
+        : chunks_(a), size_(0) {
+        MYSTL_TRY {
+            resize(n, value);
+        }
+        MYSTL_CATCH_ALL {
+            clear();
+            release_chunks(0);
+            MYSTL_RETHROW;
+        }
+    }
+
+    explicit chunked_vector(size_type n, const allocator_type& a = allocator_type())
+        : chunks_(a), size_(0) {
+        MYSTL_TRY {
+            resize(n);
+        }
+        MYSTL_CATCH_ALL {
+            clear();
+            release_chunks(0);
+            MYSTL_RETHROW;
+        }
+    }
+
+    template <typename InputIt,typename = typename msl::enable_if<!msl::is_integer<InputIt>::Integral::value>::type>
+    chunked_vector(InputIt first, InputIt last, const allocator_type& a = allocator_type())
+        : chunks_(a), size_(0) {
+        MYSTL_TRY {
+            for (; first != last; ++first) push_back(*first);
+        }
+        MYSTL_CATCH_ALL {
+            clear();
+            release_chunks(0);
+            MYSTL_RETHROW;
+        }
+    }
+
+    chunked_vector(const chunked_vector& x) : chunks_(x.chunks_.get_allocator()), size_(0) {
+        MYSTL_TRY {
+            reserve(x.size());
+            for (size_type i = 0; i < x.size_; ++i) push_back(x[i]);
+        }
+        MYSTL_CATCH_ALL {
+            clear();
+            release_chunks(0);
+            MYSTL_RETHROW;
+        }
+    }
+
+#ifdef MYSTL_HAS_MOVE_SEMANTICS
+    chunked_vector(chunked_vector&& x) noexcept : chunks_(msl::move(x.chunks_)), size_(x.size_) {
+        x.size_ = 0;
+    }
+
+    chunked_vector& operator=(chunked_vector&& x) noexcept {
+        if (this != &x) {
+            clear();
+            release_chunks(0);
+            chunks_ = msl::move(x.chunks_);
+            size_ = x.size_;
+            x.size_ = 0;
+        }
+        return *this;
+    }
+#endif
+
+    chunked_vector& operator=(const chunked_vector& x) {
+        if (this != &x) {
+            clear();
+            reserve(x.size());
+            for (size_type i = 0; i < x.size_; ++i) push_back(x[i]);
+        }
+        return *this;
+    }
+
+    ~chunked_vector() {
+        clear();
+        release_chunks(0);
+    }
+
+    allocator_type get_allocator() const { return chunks_.get_allocator(); }
+
+    iterator begin() { return iterator(chunks_.data(), 0); }
+    const_iterator begin() const { return const_iterator(chunks_.data(), 0); }
+    iterator end() { return iterator(chunks_.data(), size_); }
+    const_iterator end() const { return const_iterator(chunks_.data(), size_); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    size_type size() const { return size_; }
+    size_type capacity() const { return chunks_.size() << SHIFT; }
+    bool empty() const { return size_ == 0; }
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+    reference operator[](size_type n) { return *slot(n); }
+    const_reference operator[](size_type n) const { return *slot(n); }
+    reference at(size_type n) {
+        if (n >= size_) MYSTL_THROW(std::out_of_range("Index out of range"));
+        return *slot(n);
+    }
+    const_reference at(size_type n) const {
+        if (n >= size_) MYSTL_THROW(std::out_of_range("Index out of range"));
+        return *slot(n);
+    }
+    reference front() { return *slot(0); }
+    const_reference front() const { return *slot(0); }
+    reference back() { return *slot(size_ - 1); }
+    const_reference back() const { return *slot(size_ - 1); }
+
+    /**
+     * @brief 预先分配能容纳 n 个元素的块
+     */
+    void reserve(size_type n) {
+        const size_type need = chunks_for(n);
+        if (need <= chunks_.size()) return;
+        chunks_.reserve(need);
+        while (chunks_.size() < need) add_chunk();
+    }
+
+    void push_back(const_reference value) {
+        if (size_ == capacity()) add_chunk();
+        msl::construct(slot(size_), value);
+        ++size_;
+    }
+
+#if MYSTL_CPP_VERSION >= 11
+    void push_back(value_type&& value) {
+        if (size_ == capacity()) add_chunk();
+        msl::construct(slot(size_), msl::move(value));
+        ++size_;
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity()) add_chunk();
+        T* p = slot(size_);
+        new (static_cast<void*>(p)) T(msl::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+#endif
+
+    void pop_back() {
+        --size_;
+        msl::destroy(slot(size_));
+    }
+
+    void resize(size_type n, const_reference value = T()) {
+        if (n < size_) {
+            while (size_ > n) pop_back();
+            return;
+        }
+        reserve(n);
+        while (size_ < n) push_back(value);
+    }
+
+    /**
+     * @brief 析构所有元素, 保留已经分配的块
+     */
+    void clear() {
+        for (size_type c = 0; size_ && c < chunks_.size(); ++c) {
+            const size_type n = size_ < size_type(CHUNK_SIZE) ? size_ : size_type(CHUNK_SIZE);
+            msl::destroy(chunks_[c], chunks_[c] + n);
+            size_ -= n;
+        }
+    }
+
+    /**
+     * @brief 释放没有使用的块
+     */
+    void shrink_to_fit() {
+        release_chunks(chunks_for(size_));
+        chunks_.shrink_to_fit();
+    }
+
+    void swap(chunked_vector& x) {
+        chunks_.swap(x.chunks_);
+        msl::swap(size_, x.size_);
+    }
+
+    /**
+     * @brief 依次对每一块中的连续区间 [first, last) 调用 f(first, last)
+     */
+    template <typename Function>
+    void for_each_segment(Function f) {
+        for (size_type c = 0, left = size_; left; ++c) {
+            const size_type n = left < size_type(CHUNK_SIZE) ? left : size_type(CHUNK_SIZE);
+            f(chunks_[c], chunks_[c] + n);
+            left -= n;
+        }
+    }
+};
+
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator==(const chunked_vector<T, ChunkSize, Alloc>& x,
+                       const chunked_vector<T, ChunkSize, Alloc>& y) {
+    return x.size() == y.size() && msl::equal(x.begin(), x.end(), y.begin());
+}
+
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator!=(const chunked_vector<T, ChunkSize, Alloc>& x,
+                       const chunked_vector<T, ChunkSize, Alloc>& y) {
+    return !(x == y);
+}
+
+template <typename T, size_t ChunkSize, typename Alloc>
+inline void swap(chunked_vector<T, ChunkSize, Alloc>& x, chunked_vector<T, ChunkSize, Alloc>& y) {
+    x.swap(y);
+}
+
+/**
+ * @brief 按块处理的 for_each, 每块内部按普通指针遍历
+ */
+template <typename T, typename Ref, typename Ptr, size_t Shift, typename Function>
+Function for_each(__chunked_iterator<T, Ref, Ptr, Shift> first,
+                  __chunked_iterator<T, Ref, Ptr, Shift> last, Function f) {
+    while (first != last) {
+        Ptr p = &*first;
+        Ptr e = first.segment_end(last);
+        first += e - p;
+        for (; p != e; ++p) f(*p);
+    }
+    return f;
+}
+
+/**
+ * @brief 按块处理的 copy, 每块交给指针版本的 copy(平凡类型为 memmove)
+ */
+template <typename T, typename Ref, typename Ptr, size_t Shift, typename OutputIterator>
+OutputIterator copy(__chunked_iterator<T, Ref, Ptr, Shift> first,
+                    __chunked_iterator<T, Ref, Ptr, Shift> last, OutputIterator result) {
+    while (first != last) {
+        const T* p = &*first;
+        const T* e = first.segment_end(last);
+        first += e - p;
+        result = msl::copy(p, e, result);
+    }
+    return result;
+}
+
+} // namespace msl
+
+#endif // MYSTL_CHUNKED_VECTOR_H
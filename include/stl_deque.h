@@ -111,10 +111,10 @@ struct __deque_iterator {
 
 
 template <typename T, typename Alloc, size_t BufSiz>
-class _deque_base {
+class _deque_base : public alloc_holder<Alloc> {
 public:
     typedef Alloc allocator_type;
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return this->get_alloc(); }
 
 protected:
     typedef __deque_iterator<T, T&, T*, BufSiz> iterator;
@@ -130,11 +130,11 @@ protected:
 
     static size_t buffer_size() { return iterator::buffer_size(); }
 
-    T* allocate_node() { return data_allocator::allocate(buffer_size()); }
-    void deallocate_node(T* p) { data_allocator::deallocate(p, buffer_size()); }
+    T* allocate_node() { return data_allocator::allocate(this->get_alloc(), buffer_size()); }
+    void deallocate_node(T* p) { data_allocator::deallocate(this->get_alloc(), p, buffer_size()); }
 
-    T** allocate_map(size_t n) { return map_allocator::allocate(n); }
-    void deallocate_map(T** p, size_t n) { map_allocator::deallocate(p, n); }
+    T** allocate_map(size_t n) { return map_allocator::allocate(this->get_alloc(), n); }
+    void deallocate_map(T** p, size_t n) { map_allocator::deallocate(this->get_alloc(), p, n); }
 
     void create_map_and_nodes(size_t num_elements) {
         size_t num_nodes = num_elements / buffer_size() + 1;
@@ -164,8 +164,10 @@ protected:
     }
 
 public:
-    _deque_base(const allocator_type&) : map_(0), map_size_(0), start_(), finish_() {}
-    _deque_base(const allocator_type&, size_t n) : map_(0), map_size_(0), start_(), finish_() 
+    _deque_base(const allocator_type& a)
+        : alloc_holder<Alloc>(a), map_(0), map_size_(0), start_(), finish_() {}
+    _deque_base(const allocator_type& a, size_t n)
+        : alloc_holder<Alloc>(a), map_(0), map_size_(0), start_(), finish_() 
     { create_map_and_nodes(n); }
 
     ~_deque_base() {
@@ -211,6 +213,7 @@ protected:
     using base::finish_;
     using base::map_;
     using base::map_size_;
+    using base::swap_alloc;
 
 public:
     iterator begin() { return start_;}
@@ -328,6 +331,7 @@ public:
         msl::swap(finish_, x.finish_);
         msl::swap(map_, x.map_);
         msl::swap(map_size_, x.map_size_);
+        swap_alloc(x);
     }
 
     void assign(size_type n, const value_type& val) {
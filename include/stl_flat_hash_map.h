@@ -0,0 +1,138 @@
+#ifndef STL_FLAT_HASH_MAP_H
+#define STL_FLAT_HASH_MAP_H
+
+#include "stl_alloc.h"
+#include "stl_pair.h"
+#include "stl_hash_fun.h"
+#include "stl_functional.h"
+#include "stl_flat_hashtable.h"
+
+namespace msl {
+
+/**
+ * @brief 开放定址的 hash_map, 元素直接存放在槽位数组中
+ *
+ * 接口与 hash_map 相同。查找通常只访问一段连续的内存, 也没有每个元素一个
+ * 节点的开销; 代价是插入和扩容会移动元素, 迭代器, 指针和引用随之失效。
+ * 见 flat_hashtable。
+ */
+template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc>
+class flat_hash_map {
+private:
+    typedef flat_hashtable<pair<const Key, T>, Key, HashFcn, select1st<pair<const Key, T>>, EqualKey, Alloc> ht;
+    ht rep;
+
+public:
+    typedef typename ht::key_type key_type;
+    typedef T data_type;
+    typedef T mapped_type;
+    typedef typename ht::value_type value_type;
+    typedef typename ht::hasher hasher;
+    typedef typename ht::key_equal key_equal;
+
+    typedef typename ht::size_type size_type;
+    typedef typename ht::difference_type difference_type;
+    typedef typename ht::pointer pointer;
+    typedef typename ht::const_pointer const_pointer;
+    typedef typename ht::reference reference;
+    typedef typename ht::const_reference const_reference;
+
+    typedef typename ht::iterator iterator;
+    typedef typename ht::const_iterator const_iterator;
+    typedef typename ht::allocator_type allocator_type;
+
+    hasher hash_funct() const { return rep.hash_funct(); }
+    key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
+
+public:
+    flat_hash_map() : rep(100, hasher(), key_equal()) {}
+    explicit flat_hash_map(size_type n) : rep(n, hasher(), key_equal()) {}
+    flat_hash_map(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
+    flat_hash_map(size_type n, const hasher& hf, const key_equal& eql) : rep(n, hf, eql) {}
+    flat_hash_map(size_type n, const hasher& hf, const key_equal& eql, const allocator_type& a)
+        : rep(n, hf, eql, a) {}
+
+    template <class InputIterator>
+    flat_hash_map(InputIterator first, InputIterator last)
+        : rep(100, hasher(), key_equal()) {
+        rep.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    flat_hash_map(InputIterator first, InputIterator last, size_type n)
+        : rep(n, hasher(), key_equal()) {
+        rep.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    flat_hash_map(InputIterator first, InputIterator last, size_type n, const hasher& hf)
+        : rep(n, hf, key_equal()) {
+        rep.insert_unique(first, last);
+    }
+
+    size_type size() const { return rep.size(); }
+    size_type max_size() const { return rep.max_size(); }
+    bool empty() const { return rep.empty(); }
+
+    void swap(flat_hash_map& hm) { rep.swap(hm.rep); }
+
+    template <class K, class U, class H, class E, class A>
+    friend bool operator==(const flat_hash_map<K, U, H, E, A>&, const flat_hash_map<K, U, H, E, A>&);
+
+    iterator begin() { return rep.begin(); }
+    iterator end() { return rep.end(); }
+    const_iterator begin() const { return rep.begin(); }
+    const_iterator end() const { return rep.end(); }
+
+    pair<iterator, bool> insert(const value_type& obj) { return rep.insert_unique(obj); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) { rep.insert_unique(first, last); }
+
+    pair<iterator, bool> insert_noresize(const value_type& obj) { return rep.insert_unique_noresize(obj); }
+
+    iterator find(const key_type& key) { return rep.find(key); }
+    const_iterator find(const key_type& key) const { return rep.find(key); }
+
+    T& operator[](const key_type& key) {
+        iterator it = rep.find(key);
+        if (it != rep.end()) return it->second;
+        return rep.insert_unique(value_type(key, T())).first->second;
+    }
+
+    size_type count(const key_type& key) const { return rep.count(key); }
+
+    size_type erase(const key_type& key) { return rep.erase(key); }
+    iterator erase(const_iterator it) { return rep.erase(it); }
+    iterator erase(const_iterator first, const_iterator last) { return rep.erase(first, last); }
+    void clear() { rep.clear(); }
+
+public:
+    void resize(size_type hint) { rep.resize(hint); }
+    size_type bucket_count() const { return rep.bucket_count(); }
+    size_type max_bucket_count() const { return rep.max_bucket_count(); }
+    size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
+};
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+inline bool operator==(const flat_hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm1,
+                       const flat_hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+    return hm1.rep == hm2.rep;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+inline bool operator!=(const flat_hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm1,
+                       const flat_hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+    return !(hm1 == hm2);
+}
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+inline void swap(flat_hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm1,
+                 flat_hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+    hm1.swap(hm2);
+}
+
+} // namespace msl
+
+#endif
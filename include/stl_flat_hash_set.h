@@ -0,0 +1,133 @@
+#ifndef STL_FLAT_HASH_SET_H
+#define STL_FLAT_HASH_SET_H
+
+#include "stl_alloc.h"
+#include "stl_hash_fun.h"
+#include "stl_functional.h"
+#include "stl_flat_hashtable.h"
+
+namespace msl {
+
+/**
+ * @brief 开放定址的 hash_set, 元素直接存放在槽位数组中
+ *
+ * 接口与 hash_set 相同, 插入和扩容会使迭代器失效, 见 flat_hashtable。
+ */
+template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc>
+class flat_hash_set {
+private:
+    typedef flat_hashtable<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc> ht;
+    ht rep;
+
+public:
+    typedef typename ht::key_type key_type;
+    typedef typename ht::value_type value_type;
+    typedef typename ht::hasher hasher;
+    typedef typename ht::key_equal key_equal;
+
+    typedef typename ht::size_type size_type;
+    typedef typename ht::difference_type difference_type;
+    typedef typename ht::const_pointer pointer;
+    typedef typename ht::const_pointer const_pointer;
+    typedef typename ht::const_reference reference;
+    typedef typename ht::const_reference const_reference;
+
+    typedef typename ht::const_iterator iterator;
+    typedef typename ht::const_iterator const_iterator;
+    typedef typename ht::allocator_type allocator_type;
+
+    hasher hash_funct() const { return rep.hash_funct(); }
+    key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
+
+public:
+    flat_hash_set() : rep(100, hasher(), key_equal()) {}
+    explicit flat_hash_set(size_type n) : rep(n, hasher(), key_equal()) {}
+    flat_hash_set(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
+    flat_hash_set(size_type n, const hasher& hf, const key_equal& eql) : rep(n, hf, eql) {}
+    flat_hash_set(size_type n, const hasher& hf, const key_equal& eql, const allocator_type& a)
+        : rep(n, hf, eql, a) {}
+
+    template <class InputIterator>
+    flat_hash_set(InputIterator first, InputIterator last)
+        : rep(100, hasher(), key_equal()) {
+        rep.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    flat_hash_set(InputIterator first, InputIterator last, size_type n)
+        : rep(n, hasher(), key_equal()) {
+        rep.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    flat_hash_set(InputIterator first, InputIterator last, size_type n, const hasher& hf)
+        : rep(n, hf, key_equal()) {
+        rep.insert_unique(first, last);
+    }
+
+    size_type size() const { return rep.size(); }
+    size_type max_size() const { return rep.max_size(); }
+    bool empty() const { return rep.empty(); }
+
+    void swap(flat_hash_set& hs) { rep.swap(hs.rep); }
+
+    template <class V, class H, class E, class A>
+    friend bool operator==(const flat_hash_set<V, H, E, A>&, const flat_hash_set<V, H, E, A>&);
+
+    iterator begin() const { return rep.begin(); }
+    iterator end() const { return rep.end(); }
+
+    pair<iterator, bool> insert(const value_type& obj) {
+        pair<typename ht::iterator, bool> p = rep.insert_unique(obj);
+        return pair<iterator, bool>(iterator(p.first), p.second);
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        rep.insert_unique(first, last);
+    }
+
+    pair<iterator, bool> insert_noresize(const value_type& obj) {
+        pair<typename ht::iterator, bool> p = rep.insert_unique_noresize(obj);
+        return pair<iterator, bool>(iterator(p.first), p.second);
+    }
+
+    iterator find(const key_type& key) const { return rep.find(key); }
+
+    size_type count(const key_type& key) const { return rep.count(key); }
+
+    size_type erase(const key_type& key) { return rep.erase(key); }
+    iterator erase(iterator it) { return rep.erase(it); }
+    iterator erase(iterator first, iterator last) { return rep.erase(first, last); }
+
+    void clear() { rep.clear(); }
+
+public:
+    void resize(size_type hint) { rep.resize(hint); }
+    size_type bucket_count() const { return rep.bucket_count(); }
+    size_type max_bucket_count() const { return rep.max_bucket_count(); }
+    size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
+};
+
+template <class Value, class HashFcn, class EqualKey, class Alloc>
+inline bool operator==(const flat_hash_set<Value, HashFcn, EqualKey, Alloc>& hs1,
+                       const flat_hash_set<Value, HashFcn, EqualKey, Alloc>& hs2) {
+    return hs1.rep == hs2.rep;
+}
+
+template <class Value, class HashFcn, class EqualKey, class Alloc>
+inline bool operator!=(const flat_hash_set<Value, HashFcn, EqualKey, Alloc>& hs1,
+                       const flat_hash_set<Value, HashFcn, EqualKey, Alloc>& hs2) {
+    return !(hs1 == hs2);
+}
+
+template <class Value, class HashFcn, class EqualKey, class Alloc>
+inline void swap(flat_hash_set<Value, HashFcn, EqualKey, Alloc>& hs1,
+                 flat_hash_set<Value, HashFcn, EqualKey, Alloc>& hs2) {
+    hs1.swap(hs2);
+}
+
+} // namespace msl
+
+#endif
@@ -0,0 +1,518 @@
+#ifndef STL_FLAT_HASHTABLE_H
+#define STL_FLAT_HASHTABLE_H
+
+#include "stl_alloc.h"
+#include "stl_iterator.h"
+#include "stl_construct.h"
+#include "stl_algobase.h"
+#include "stl_pair.h"
+#include "stl_hash_fun.h"
+#include "stl_functional.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace msl{
+
+//迭代器: 同时指向槽位和它的探测距离字节, 槽位数组末尾有一个非 0 的哨兵字节
+template<typename value, typename Ref, typename Ptr>
+struct flat_hashtable_iterator{
+    typedef flat_hashtable_iterator<value, value&, value*> iterator;
+    typedef flat_hashtable_iterator<value, const value&, const value*> const_iterator;
+    typedef flat_hashtable_iterator<value, Ref, Ptr> self;
+
+    typedef forward_iterator_tag iterator_category;
+    typedef value value_type;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef Ref reference;
+    typedef Ptr pointer;
+
+    value* cur;
+    const unsigned char* info;
+
+    flat_hashtable_iterator(value* c, const unsigned char* i) : cur(c), info(i) {}
+    flat_hashtable_iterator() : cur(0), info(0) {}
+    // iterator 转换为 const_iterator; 对 iterator 本身这就是拷贝构造函数,
+    // 所以显式声明拷贝赋值, 否则隐式的拷贝赋值已被弃用(-Wdeprecated-copy)
+    flat_hashtable_iterator(const iterator& it) : cur(it.cur), info(it.info) {}
+    self& operator=(const self&) = default;
+
+    reference operator*() const { return *cur; }
+    pointer operator->() const { return cur; }
+    self& operator++(){
+        do {
+            ++cur;
+            ++info;
+        } while(!*info);
+        return *this;
+    }
+    self operator++(int){
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    bool operator==(const self& it) const { return cur == it.cur; }
+    bool operator!=(const self& it) const { return cur != it.cur; }
+};
+
+/**
+ * @brief 开放定址的哈希表, 元素直接存放在一个槽位数组中
+ *
+ * 使用 robin hood 线性探测: 每个槽位有一个字节记录元素离自己主槽位的距离
+ * (0 表示空槽), 插入时距离更远的元素优先占位, 所以同一簇中的元素按主槽位
+ * 排列, 查找遇到距离比当前探测距离小的槽位即可判定不存在。删除时把后面的
+ * 元素前移一格(backward shift), 不留墓碑。
+ *
+ * 主槽位数是 2 的幂, 数组末尾另有至多 255 个溢出槽位, 探测不回绕。
+ * 装载率(元素数/主槽位数)超过 1/2, 或者探测距离超过 255 时扩容为两倍。
+ * 线性探测在装载率较高时探测长度和分支预测失败都明显增加, 所以上限取得较低。
+ *
+ * 与链式 hashtable 的区别: 插入和扩容会移动元素, 所有迭代器, 指针和引用
+ * 都会失效; 删除只使被删元素之后同一簇中的迭代器失效。元素的移动构造
+ * 不应抛出异常。只支持键唯一的插入。
+ *
+ * @tparam value 元素类型
+ * @tparam key 键类型
+ * @tparam hashfcn 哈希函数类型
+ * @tparam extractkey 提取键的函数类型
+ * @tparam equalkey 键相等判断函数类型
+ * @tparam Alloc 分配器类型
+ */
+template<typename value, typename key, typename hashfcn,
+         typename extractkey, class equalkey, typename Alloc = alloc>
+class flat_hashtable : protected alloc_holder<Alloc> {
+public:
+    typedef key key_type;
+    typedef value value_type;
+    typedef hashfcn hasher;
+    typedef equalkey key_equal;
+
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    typedef flat_hashtable_iterator<value, value&, value*> iterator;
+    typedef flat_hashtable_iterator<value, const value&, const value*> const_iterator;
+
+    typedef Alloc allocator_type;
+    allocator_type get_allocator() const { return this->get_alloc(); }
+
+private:
+    typedef simple_alloc<char, Alloc> data_allocator;
+
+    enum { max_distance = 255 };
+    static const size_type npos = size_type(-1);
+
+    hasher hash;
+    equalkey equals;
+    extractkey get_key;
+
+    value_type* slots;              // total 个槽位
+    unsigned char* info;            // total + 1 个字节: 0 为空槽, 否则为探测距离 + 1; info[total] 为哨兵
+    size_type total;                // 主槽位 + 溢出槽位
+    size_type num_elements;
+    size_type max_elements;         // 主槽位数的一半
+    unsigned shift;                 // __fib_hash_index 的右移位数
+
+public:
+    hasher hash_funct() const { return hash; }
+    key_equal key_eq() const { return equals; }
+
+    size_type size() const { return num_elements; }
+    size_type max_size() const { return size_type(-1) / (sizeof(value_type) + 1) / 2; }
+    bool empty() const { return num_elements == 0; }
+
+    // 槽位数, 包括溢出槽位
+    size_type bucket_count() const { return total; }
+    size_type max_bucket_count() const { return max_size(); }
+    size_type elems_in_bucket(size_type n) const { return info[n] != 0; }
+
+private:
+    size_type main_slots() const { return size_type(1) << (sizeof(size_t) * 8 - shift); }
+
+    size_type home(const key_type& k) const { return __fib_hash_index(hash(k), shift); }
+
+    static size_type block_bytes(size_type n) { return n * sizeof(value_type) + n + 1; }
+
+    // 分配 2^bits 个主槽位的空数组
+    void allocate_slots(unsigned bits) {
+        const size_type cap = size_type(1) << bits;
+        const size_type n = cap + (cap < size_type(max_distance) ? cap : size_type(max_distance));
+        char* p = data_allocator::allocate(this->get_alloc(), block_bytes(n));
+        slots = reinterpret_cast<value_type*>(p);
+        info = reinterpret_cast<unsigned char*>(p + n * sizeof(value_type));
+        memset(info, 0, n);
+        info[n] = 1;
+        total = n;
+        num_elements = 0;
+        max_elements = cap / 2;
+        shift = static_cast<unsigned>(sizeof(size_t) * 8 - bits);
+    }
+
+    void deallocate_slots() {
+        data_allocator::deallocate(this->get_alloc(), reinterpret_cast<char*>(slots), block_bytes(total));
+    }
+
+    // 容纳 n 个元素需要的主槽位位数
+    static unsigned bits_for(size_type n) {
+        unsigned bits = 3;
+        while ((size_type(1) << bits) / 2 < n) ++bits;
+        return bits;
+    }
+
+    void destroy_all() {
+        if (!type_traits<value_type>::is_trivially_destructible::value) {
+            for (size_type i = 0; i < total; ++i)
+                if (info[i]) destroy(slots + i);
+        }
+    }
+
+    iterator make_iterator(size_type i) { return iterator(slots + i, info + i); }
+    const_iterator make_iterator(size_type i) const { return const_iterator(slots + i, info + i); }
+
+    size_type find_index(const key_type& k) const {
+        size_type i = home(k);
+        for (unsigned d = 1; info[i] >= d; ++i, ++d) {
+            if (info[i] == d && equals(get_key(slots[i]), k))
+                return i;
+        }
+        return npos;
+    }
+
+    /**
+     * @brief 在位置 i 放入距离为 d 的元素, 后面同一簇的元素后移一格
+     *
+     * @return 溢出(距离超过 255 或者没有空槽)时返回 false, 表不变
+     */
+    template <class Construct>
+    bool place(size_type i, unsigned d, const Construct& make) {
+        if (d > max_distance) return false;
+        size_type e = i;
+        for (; e < total && info[e]; ++e) {
+            if (info[e] == max_distance) return false;
+        }
+        if (e == total) return false;
+        for (size_type j = e; j > i; --j) {
+            construct(slots + j, msl::move(slots[j - 1]));
+            destroy(slots + j - 1);
+            info[j] = static_cast<unsigned char>(info[j - 1] + 1);
+        }
+        MYSTL_TRY{
+            make(slots + i);
+        }
+        MYSTL_CATCH_ALL{
+            // 把后移的元素移回来
+            for (size_type j = i; j < e; ++j) {
+                construct(slots + j, msl::move(slots[j + 1]));
+                destroy(slots + j + 1);
+                info[j] = static_cast<unsigned char>(info[j + 1] - 1);
+            }
+            info[e] = 0;
+            MYSTL_RETHROW;
+        }
+        info[i] = static_cast<unsigned char>(d);
+        ++num_elements;
+        return true;
+    }
+
+    struct copy_maker {
+        const value_type& val;
+        explicit copy_maker(const value_type& v) : val(v) {}
+        void operator()(value_type* p) const { construct(p, val); }
+    };
+
+    struct move_maker {
+        value_type& val;
+        explicit move_maker(value_type& v) : val(v) {}
+        void operator()(value_type* p) const { construct(p, msl::move(val)); }
+    };
+
+    // 放入键不重复的元素(扩容时使用), 溢出时继续扩容
+    void place_unique(value_type& val) {
+        for (;;) {
+            size_type i = home(get_key(val));
+            unsigned d = 1;
+            for (; info[i] >= d; ++i, ++d) {}
+            if (place(i, d, move_maker(val))) return;
+            rehash(sizeof(size_t) * 8 - shift + 1);
+        }
+    }
+
+    // 改为 2^bits 个主槽位, 元素逐个移动到新数组
+    void rehash(unsigned bits) {
+        value_type* old_slots = slots;
+        unsigned char* old_info = info;
+        const size_type old_total = total;
+        allocate_slots(bits);
+        for (size_type i = 0; i < old_total; ++i) {
+            if (old_info[i]) {
+                place_unique(old_slots[i]);
+                destroy(old_slots + i);
+            }
+        }
+        data_allocator::deallocate(this->get_alloc(), reinterpret_cast<char*>(old_slots), block_bytes(old_total));
+    }
+
+    void grow() {
+        // 探测距离溢出时装载率还很低, 说明大量键的完整哈希值相同, 扩容无济于事
+        if (num_elements < main_slots() / 8)
+            MYSTL_THROW(std::overflow_error("flat_hashtable: too many equal hash values"));
+        rehash(sizeof(size_t) * 8 - shift + 1);
+    }
+
+    void erase_index(size_type i) {
+        destroy(slots + i);
+        for (size_type j = i + 1; info[j] > 1; ++i, ++j) {
+            construct(slots + i, msl::move(slots[j]));
+            destroy(slots + j);
+            info[i] = static_cast<unsigned char>(info[j] - 1);
+        }
+        info[i] = 0;
+        --num_elements;
+    }
+
+    void copy_from(const flat_hashtable& ht);
+
+public:
+    flat_hashtable(size_type n,
+                   const hashfcn& hf,
+                   const equalkey& eql,
+                   const allocator_type& a = allocator_type())
+        : alloc_holder<Alloc>(a), hash(hf), equals(eql), get_key(extractkey())
+    {
+        allocate_slots(bits_for(n));
+    }
+
+    flat_hashtable(size_type n,
+                   const hashfcn& hf,
+                   const equalkey& eql,
+                   const extractkey& getk,
+                   const allocator_type& a = allocator_type())
+        : alloc_holder<Alloc>(a), hash(hf), equals(eql), get_key(getk)
+    {
+        allocate_slots(bits_for(n));
+    }
+
+    flat_hashtable(const flat_hashtable& ht)
+        : alloc_holder<Alloc>(ht.get_alloc()), hash(ht.hash), equals(ht.equals), get_key(ht.get_key)
+    {
+        copy_from(ht);
+    }
+
+    flat_hashtable& operator=(const flat_hashtable& ht){
+        if(this != &ht){
+            flat_hashtable tmp(ht);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~flat_hashtable() {
+        destroy_all();
+        deallocate_slots();
+    }
+
+    /**
+     * @brief 插入唯一元素
+     *
+     * @param val 要插入的元素
+     * @return pair<iterator, bool> 插入结果, 第一个元素是迭代器, 第二个元素是是否插入成功
+     */
+    pair<iterator, bool> insert_unique(const value_type& val) {
+        if (num_elements + 1 > max_elements) {
+            // 先查找再扩容: 键已存在时不必扩容(否则迭代器全部失效),
+            // 而且 val 可能就是表中的元素, 扩容会释放它
+            const size_type i = find_index(get_key(val));
+            if (i != npos)
+                return pair<iterator, bool>(make_iterator(i), false);
+            resize(num_elements + 1);
+        }
+        return insert_unique_noresize(val);
+    }
+
+    /**
+     * @brief 插入唯一元素, 装载率超过上限也不扩容
+     *
+     * 探测距离溢出时仍然需要扩容。
+     */
+    pair<iterator, bool> insert_unique_noresize(const value_type& val) {
+        for (;;) {
+            const key_type& k = get_key(val);
+            size_type i = home(k);
+            unsigned d = 1;
+            for (; info[i] >= d; ++i, ++d) {
+                if (info[i] == d && equals(get_key(slots[i]), k))
+                    return pair<iterator, bool>(make_iterator(i), false);
+            }
+            if (place(i, d, copy_maker(val)))
+                return pair<iterator, bool>(make_iterator(i), true);
+            grow();
+        }
+    }
+
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last) {
+        resize(num_elements + range_size_hint(first, last));
+        for (; first != last; ++first)
+            insert_unique(*first);
+    }
+
+    iterator find(const key_type& k) {
+        const size_type i = find_index(k);
+        return i == npos ? end() : make_iterator(i);
+    }
+
+    const_iterator find(const key_type& k) const {
+        const size_type i = find_index(k);
+        return i == npos ? end() : make_iterator(i);
+    }
+
+    size_type count(const key_type& k) const {
+        return find_index(k) == npos ? 0 : 1;
+    }
+
+    void swap(flat_hashtable& ht) {
+        this->swap_alloc(ht);
+        msl::swap(hash, ht.hash);
+        msl::swap(equals, ht.equals);
+        msl::swap(get_key, ht.get_key);
+        msl::swap(slots, ht.slots);
+        msl::swap(info, ht.info);
+        msl::swap(total, ht.total);
+        msl::swap(num_elements, ht.num_elements);
+        msl::swap(max_elements, ht.max_elements);
+        msl::swap(shift, ht.shift);
+    }
+
+    /**
+     * @brief 删除指定键的元素
+     *
+     * @param k 要删除的键
+     * @return size_type 删除的元素数量
+     */
+    size_type erase(const key_type& k) {
+        const size_type i = find_index(k);
+        if (i == npos) return 0;
+        erase_index(i);
+        return 1;
+    }
+
+    /**
+     * @brief 删除指定迭代器指向的元素
+     *
+     * @return iterator 下一个元素: 后面的元素前移到了当前槽位时就是 it 本身
+     */
+    iterator erase(const_iterator it) {
+        const size_type i = it.cur - slots;
+        erase_index(i);
+        iterator next = make_iterator(i);
+        if (!info[i]) ++next;
+        return next;
+    }
+
+    /**
+     * @brief 删除指定迭代器范围内的元素
+     *
+     * 删除会使后面的元素前移, last 可能随之失效, 所以先数出元素个数。
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        size_type n = 0;
+        for (const_iterator it = first; it != last; ++it) ++n;
+        iterator cur = make_iterator(first.cur - slots);
+        for (; n > 0; --n) cur = erase(cur);
+        return cur;
+    }
+
+    iterator begin() {
+        size_type i = 0;
+        while (!info[i]) ++i;
+        return make_iterator(i);
+    }
+
+    iterator end() { return make_iterator(total); }
+
+    const_iterator begin() const {
+        size_type i = 0;
+        while (!info[i]) ++i;
+        return make_iterator(i);
+    }
+
+    const_iterator end() const { return make_iterator(total); }
+
+    /**
+     * @brief 清空哈希表, 保留槽位数组
+     */
+    void clear() {
+        destroy_all();
+        memset(info, 0, total);
+        num_elements = 0;
+    }
+
+    /**
+     * @brief 保证容纳 num_elements_hint 个元素时不需要扩容
+     */
+    void resize(size_type num_elements_hint) {
+        if (num_elements_hint > max_elements)
+            rehash(bits_for(num_elements_hint));
+    }
+};
+
+template<typename v, typename k, typename hf, typename ex, typename eq, typename a>
+const typename flat_hashtable<v,k,hf,ex,eq,a>::size_type flat_hashtable<v,k,hf,ex,eq,a>::npos;
+
+// 槽位布局相同, 逐个复制
+template<typename v, typename k, typename hf, typename ex, typename eq, typename a>
+void flat_hashtable<v,k,hf,ex,eq,a>::copy_from(const flat_hashtable& ht) {
+    allocate_slots(sizeof(size_t) * 8 - ht.shift);
+    size_type i = 0;
+    MYSTL_TRY{
+        for (; i < total; ++i) {
+            if (ht.info[i]) {
+                construct(slots + i, ht.slots[i]);
+                info[i] = ht.info[i];
+            }
+        }
+        num_elements = ht.num_elements;
+    }
+    MYSTL_CATCH_ALL{
+        destroy_all();
+        deallocate_slots();
+        MYSTL_RETHROW;
+    }
+}
+
+template<typename v, typename k, typename hf, typename ex, typename eq, typename a>
+bool operator==(const flat_hashtable<v,k,hf,ex,eq,a>& ht1, const flat_hashtable<v,k,hf,ex,eq,a>& ht2) {
+    if (ht1.size() != ht2.size()) return false;
+    ex get_key;
+    for (typename flat_hashtable<v,k,hf,ex,eq,a>::const_iterator it = ht1.begin(); it != ht1.end(); ++it) {
+        typename flat_hashtable<v,k,hf,ex,eq,a>::const_iterator pos = ht2.find(get_key(*it));
+        if (pos == ht2.end() || !(*pos == *it)) return false;
+    }
+    return true;
+}
+
+template<typename value, typename key, typename hashfcn,
+         typename extractkey, class equalkey, typename Alloc>
+inline void swap(flat_hashtable<value, key, hashfcn, extractkey, equalkey, Alloc>& ht1,
+                 flat_hashtable<value, key, hashfcn, extractkey, equalkey, Alloc>& ht2) {
+    ht1.swap(ht2);
+}
+
+/**
+ * @brief hash_map/hash_set 的 Engine 参数: 使用 flat_hashtable
+ */
+struct flat_hash_engine {
+    template<typename value, typename key, typename hashfcn,
+             typename extractkey, class equalkey, typename Alloc>
+    struct table {
+        typedef flat_hashtable<value, key, hashfcn, extractkey, equalkey, Alloc> type;
+    };
+};
+
+} // namespace msl
+
+#endif // STL_FLAT_HASHTABLE_H
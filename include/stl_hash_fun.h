@@ -9,38 +9,161 @@
 
 #include "stl_config.h"
 #include <string>
+#include <cstring>
 
 namespace msl{
 
 template<typename key> struct hash{ };
 
-inline size_t __stl_hash_string(const char* str) {
-    unsigned long h = 0;
-    for(; *str ; ++str){
-        h = h * 5 + *str;
+/**
+ * @brief 把哈希值映射到 2^(位宽 - shift) 个槽位
+ *
+ * 乘以 2^64/φ 后取高位(斐波那契散列)。hash<int> 这类恒等哈希的低位往往
+ * 很有规律(比如都是 8 的倍数), 直接取低位会集中到少数槽位。
+ */
+inline size_t __fib_hash_index(size_t h, unsigned shift) {
+    const size_t golden = sizeof(size_t) == 8 ? size_t(11400714819323198485ull) : size_t(2654435769u);
+    return (h * golden) >> shift;
+}
+
+/*
+ * wyhash 风格的字节串哈希。源码中的 h = h * 5 + c 每个字节一次乘加, 且只有低位
+ * 得到充分混合; 这里每次读入 8 字节, 两个 64 位数做一次 64x64->128 的乘法再把
+ * 高低两半异或(__hash_mum), 长串每轮处理 48 字节(三路并行)。
+ */
+typedef unsigned long long __hash_u64;
+
+static const __hash_u64 __hash_secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+// 64x64 -> 128 位乘法, 结果的低/高 64 位写回 a/b
+inline void __hash_mul128(__hash_u64& a, __hash_u64& b) {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<__hash_u64>(r);
+    b = static_cast<__hash_u64>(r >> 64);
+#else
+    const __hash_u64 ha = a >> 32, hb = b >> 32, la = static_cast<unsigned>(a), lb = static_cast<unsigned>(b);
+    const __hash_u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const __hash_u64 t = rl + (rm0 << 32);
+    const __hash_u64 lo = t + (rm1 << 32);
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+    a = lo;
+#endif
+}
+
+inline __hash_u64 __hash_mum(__hash_u64 a, __hash_u64 b) {
+    __hash_mul128(a, b);
+    return a ^ b;
+}
+
+inline __hash_u64 __hash_read8(const unsigned char* p) { __hash_u64 v; memcpy(&v, p, 8); return v; }
+inline __hash_u64 __hash_read4(const unsigned char* p) { unsigned v; memcpy(&v, p, 4); return v; }
+
+/**
+ * @brief 计算 [data, data + len) 的哈希值
+ *
+ * @param seed 种子, 不同的种子得到互不相关的哈希函数
+ */
+inline size_t __hash_bytes(const void* data, size_t len, __hash_u64 seed = 0) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const __hash_u64* secret = __hash_secret;
+    seed ^= __hash_mum(seed ^ secret[0], secret[1]);
+    __hash_u64 a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            // 前后两段 4 字节, 中间按 len 是否 >= 8 再取两段, 覆盖全部字节
+            const size_t mid = (len >> 3) << 2;
+            a = (__hash_read4(p) << 32) | __hash_read4(p + mid);
+            b = (__hash_read4(p + len - 4) << 32) | __hash_read4(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = (__hash_u64(p[0]) << 16) | (__hash_u64(p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            __hash_u64 see1 = seed, see2 = seed;
+            do {
+                seed = __hash_mum(__hash_read8(p) ^ secret[1], __hash_read8(p + 8) ^ seed);
+                see1 = __hash_mum(__hash_read8(p + 16) ^ secret[2], __hash_read8(p + 24) ^ see1);
+                see2 = __hash_mum(__hash_read8(p + 32) ^ secret[3], __hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = __hash_mum(__hash_read8(p) ^ secret[1], __hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        // 最后 16 字节, 可能和已经处理过的部分重叠
+        a = __hash_read8(p + i - 16);
+        b = __hash_read8(p + i - 8);
     }
-    return size_t(h);
+    a ^= secret[1];
+    b ^= seed;
+    __hash_mul128(a, b);
+    return size_t(__hash_mum(a ^ secret[0] ^ len, b ^ secret[1]));
+}
+
+/**
+ * @brief 整数的雪崩混合(splitmix64 的终结函数)
+ *
+ * 输入的每一位都会影响输出的每一位, 适合低位有规律的整数键
+ */
+inline size_t __hash_mix(__hash_u64 x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return size_t(x);
+}
+
+/*
+ * 整数键的哈希值。默认是恒等映射, 和源码一致: 链式 hashtable 默认按素数取模,
+ * pow2_bucket_policy, flat/swiss 引擎也会先打乱哈希值, 恒等映射已经足够且没有开销。
+ * 定义 MYSTL_HASH_MIX_INTEGERS 后改为 __hash_mix, 供直接取低位的自定义容器使用。
+ */
+inline size_t __hash_int(__hash_u64 x) {
+#ifdef MYSTL_HASH_MIX_INTEGERS
+    return __hash_mix(x);
+#else
+    return size_t(x);
+#endif
+}
+
+inline size_t __stl_hash_string(const char* str) {
+    return __hash_bytes(str, strlen(str));
 }
 
 /**************************************************************** */
 //非源码,但是我认为比较常用所以添加
 inline size_t __stl_hash_string(const std::string& str) {
-    unsigned long h = 0;
-    for(size_t i = 0; i < str.size(); ++i){
-        h = h * 5 + str[i];
-    }
-    return size_t(h);
+    return __hash_bytes(str.data(), str.size());
 } 
 
+// 按位模式哈希; +0.0 和 -0.0 相等, 所以先统一成 +0.0
 template<> struct hash<double> {
     size_t operator()(const double& d) const {
-        return size_t(d * 100);
+        const double v = d == 0.0 ? 0.0 : d;
+        __hash_u64 bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return __hash_mix(bits);
     }
 };
 
 template<> struct hash<float> {
     size_t operator()(const float& f) const {
-        return size_t(f * 100);
+        const float v = f == 0.0f ? 0.0f : f;
+        unsigned bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return __hash_mix(bits);
     }
 };
 
@@ -67,55 +190,55 @@ template<> struct hash<const char*> {
 
 template<> struct hash<char> {
     size_t operator()(char c) const {
-        return size_t(c);
+        return __hash_int(c);
     }
 };
 
 template<> struct hash<unsigned char> {
     size_t operator()(unsigned char c) const {
-        return size_t(c);
+        return __hash_int(c);
     }
 };
 
 template<> struct hash<signed char> {
     size_t operator()(signed char c) const {
-        return size_t(c);
+        return __hash_int(c);
     }
 };
 
 template<> struct hash<short> {
     size_t operator()(short s) const {
-        return size_t(s);
+        return __hash_int(s);
     }
 };
 
 template<> struct hash<unsigned short> {
     size_t operator()(unsigned short s) const {
-        return size_t(s);
+        return __hash_int(s);
     }
 };
 
 template<> struct hash<unsigned int> {
     size_t operator()(unsigned int i) const {
-        return size_t(i);
+        return __hash_int(i);
     }
 };
 
 template<> struct hash<int> {
     size_t operator()(int i) const {
-        return size_t(i);
+        return __hash_int(i);
     }
 };
 
 template<> struct hash<unsigned long> {
     size_t operator()(unsigned long l) const {
-        return size_t(l);
+        return __hash_int(l);
     }
 };
 
 template<> struct hash<long> {
     size_t operator()(long l) const {
-        return size_t(l);
+        return __hash_int(l);
     }
 };
 
@@ -124,13 +247,13 @@ template<> struct hash<long> {
 
 template<> struct hash<long long> {
     size_t operator()(long long l) const {
-        return size_t(l);
+        return __hash_int(l);
     }
 };
 
 template<> struct hash<unsigned long long> {
     size_t operator()(unsigned long long l) const {
-        return size_t(l);
+        return __hash_int(l);
     }
 };
 
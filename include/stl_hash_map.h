@@ -6,21 +6,31 @@
 #include "stl_hash_fun.h"
 #include "stl_functional.h"
 #include "stl_hashtable.h"
+#include "stl_flat_hashtable.h"
+#include "stl_swiss_hashtable.h"
 
 namespace msl {
 
 // Forward declaration
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class Engine>
 class hash_map;
 
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
-bool operator== (const hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm1, 
-                 const hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm2);
-
-template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc>
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class Engine>
+bool operator== (const hash_map<Key, T, HashFcn, EqualKey, Alloc, Engine>& hm1, 
+                 const hash_map<Key, T, HashFcn, EqualKey, Alloc, Engine>& hm2);
+
+/**
+ * @brief 哈希映射
+ *
+ * @tparam Engine 底层哈希表: chained_hash_engine(默认, 链式 hashtable),
+ *         flat_hash_engine 或 swiss_hash_engine(开放定址, 插入可能使迭代器失效)
+ */
+template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc,
+          class Engine = chained_hash_engine>
 class hash_map {
 private:
-    typedef hashtable<pair<const Key, T>, Key, HashFcn, select1st<pair<const Key, T>>, EqualKey, Alloc> ht;
+    typedef typename Engine::template table<pair<const Key, T>, Key, HashFcn,
+                                            select1st<pair<const Key, T>>, EqualKey, Alloc>::type ht;
     ht rep;
 
 public:
@@ -40,15 +50,19 @@ public:
 
     typedef typename ht::iterator iterator;
     typedef typename ht::const_iterator const_iterator;
+    typedef typename ht::allocator_type allocator_type;
 
     hasher hash_funct() const { return rep.hash_funct(); }
     key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
 
 public:
     hash_map() : rep(100, hasher(), key_equal()) {}
     explicit hash_map(size_type n) : rep(n, hasher(), key_equal()) {}
     hash_map(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
     hash_map(size_type n, const hasher& hf, const key_equal& eql) : rep(n, hf, eql) {}
+    hash_map(size_type n, const hasher& hf, const key_equal& eql, const allocator_type& a)
+        : rep(n, hf, eql, a) {}
 
     template <class InputIterator>
     hash_map(InputIterator first, InputIterator last) 
@@ -99,8 +113,9 @@ public:
     size_type count(const key_type& key) const { return rep.count(key); }
     
     size_type erase(const key_type& key) { return rep.erase(key); }
-    void erase(iterator it) { rep.erase(it); }
-    void erase(iterator first, iterator last) { rep.erase(first, last); }
+    // 返回被删元素的下一个元素; 开放定址的引擎删除时会移动元素, 遍历时删除必须写成 it = erase(it)
+    iterator erase(iterator it) { return rep.erase(it); }
+    iterator erase(iterator first, iterator last) { return rep.erase(first, last); }
     void clear() { rep.clear(); }
 
 public:
@@ -110,15 +125,15 @@ public:
     size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
 };
 
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
-inline bool operator== (const hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm1, 
-                        const hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class Engine>
+inline bool operator== (const hash_map<Key, T, HashFcn, EqualKey, Alloc, Engine>& hm1, 
+                        const hash_map<Key, T, HashFcn, EqualKey, Alloc, Engine>& hm2) {
     return hm1.rep == hm2.rep;
 }
 
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
-inline void swap(hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm1,
-                 hash_map<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class Engine>
+inline void swap(hash_map<Key, T, HashFcn, EqualKey, Alloc, Engine>& hm1,
+                 hash_map<Key, T, HashFcn, EqualKey, Alloc, Engine>& hm2) {
     hm1.swap(hm2);
 }
 
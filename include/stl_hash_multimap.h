@@ -10,17 +10,23 @@
 namespace msl {
 
 // Forward declaration
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
 class hash_multimap;
 
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
-bool operator== (const hash_multimap<Key, T, HashFcn, EqualKey, Alloc>& hm1, 
-                 const hash_multimap<Key, T, HashFcn, EqualKey, Alloc>& hm2);
-
-template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc>
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
+bool operator== (const hash_multimap<Key, T, HashFcn, EqualKey, Alloc, BucketPolicy>& hm1, 
+                 const hash_multimap<Key, T, HashFcn, EqualKey, Alloc, BucketPolicy>& hm2);
+
+/**
+ * @brief 键可重复的哈希映射
+ *
+ * @tparam BucketPolicy 底层 hashtable 的桶策略: prime_bucket_policy(默认) 或 pow2_bucket_policy
+ */
+template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc,
+          class BucketPolicy = prime_bucket_policy>
 class hash_multimap {
 private:
-    typedef hashtable<pair<const Key, T>, Key, HashFcn, select1st<pair<const Key, T>>, EqualKey, Alloc> ht;
+    typedef hashtable<pair<const Key, T>, Key, HashFcn, select1st<pair<const Key, T>>, EqualKey, Alloc, BucketPolicy> ht;
     ht rep;
 
 public:
@@ -40,15 +46,19 @@ public:
 
     typedef typename ht::iterator iterator;
     typedef typename ht::const_iterator const_iterator;
+    typedef typename ht::allocator_type allocator_type;
 
     hasher hash_funct() const { return rep.hash_funct(); }
     key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
 
 public:
     hash_multimap() : rep(100, hasher(), key_equal()) {}
     explicit hash_multimap(size_type n) : rep(n, hasher(), key_equal()) {}
     hash_multimap(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
     hash_multimap(size_type n, const hasher& hf, const key_equal& eql) : rep(n, hf, eql) {}
+    hash_multimap(size_type n, const hasher& hf, const key_equal& eql, const allocator_type& a)
+        : rep(n, hf, eql, a) {}
 
     template <class InputIterator>
     hash_multimap(InputIterator first, InputIterator last) 
@@ -106,15 +116,15 @@ public:
     size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
 };
 
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
-inline bool operator== (const hash_multimap<Key, T, HashFcn, EqualKey, Alloc>& hm1, 
-                        const hash_multimap<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
+inline bool operator== (const hash_multimap<Key, T, HashFcn, EqualKey, Alloc, BucketPolicy>& hm1, 
+                        const hash_multimap<Key, T, HashFcn, EqualKey, Alloc, BucketPolicy>& hm2) {
     return hm1.rep == hm2.rep;
 }
 
-template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
-inline void swap(hash_multimap<Key, T, HashFcn, EqualKey, Alloc>& hm1,
-                 hash_multimap<Key, T, HashFcn, EqualKey, Alloc>& hm2) {
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
+inline void swap(hash_multimap<Key, T, HashFcn, EqualKey, Alloc, BucketPolicy>& hm1,
+                 hash_multimap<Key, T, HashFcn, EqualKey, Alloc, BucketPolicy>& hm2) {
     hm1.swap(hm2);
 }
 
@@ -8,16 +8,22 @@
 
 namespace msl {
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
+template <class Value, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
 class hash_multiset;
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
-bool operator== (const hash_multiset<Value, HashFcn, EqualKey, Alloc>& hs1, const hash_multiset<Value, HashFcn, EqualKey, Alloc>& hs2);
+template <class Value, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
+bool operator== (const hash_multiset<Value, HashFcn, EqualKey, Alloc, BucketPolicy>& hs1, const hash_multiset<Value, HashFcn, EqualKey, Alloc, BucketPolicy>& hs2);
 
-template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc>
+/**
+ * @brief 元素可重复的哈希集合
+ *
+ * @tparam BucketPolicy 底层 hashtable 的桶策略: prime_bucket_policy(默认) 或 pow2_bucket_policy
+ */
+template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc,
+          class BucketPolicy = prime_bucket_policy>
 class hash_multiset {
 private:
-    typedef hashtable<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc> ht;
+    typedef hashtable<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc, BucketPolicy> ht;
     ht rep;
 
 public:
@@ -35,15 +41,19 @@ public:
 
     typedef typename ht::const_iterator iterator;
     typedef typename ht::const_iterator const_iterator;
+    typedef typename ht::allocator_type allocator_type;
 
     hasher hash_funct() const { return rep.hash_funct(); }
     key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
 
 public:
     hash_multiset() : rep(100, hasher(), key_equal()) {}
     explicit hash_multiset(size_type n) : rep(n, hasher(), key_equal()) {}
     hash_multiset(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
     hash_multiset(size_type n, const hasher& hf, const key_equal& eql) : rep(n, hf, eql) {}
+    hash_multiset(size_type n, const hasher& hf, const key_equal& eql, const allocator_type& a)
+        : rep(n, hf, eql, a) {}
 
     template <class InputIterator>
     hash_multiset(InputIterator first, InputIterator last) 
@@ -124,15 +134,15 @@ public:
     size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
 };
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
-inline void swap(hash_multiset<Value, HashFcn, EqualKey, Alloc>& hs1,
-                 hash_multiset<Value, HashFcn, EqualKey, Alloc>& hs2) {
+template <class Value, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
+inline void swap(hash_multiset<Value, HashFcn, EqualKey, Alloc, BucketPolicy>& hs1,
+                 hash_multiset<Value, HashFcn, EqualKey, Alloc, BucketPolicy>& hs2) {
     hs1.swap(hs2);
 }
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
-bool operator== (const hash_multiset<Value, HashFcn, EqualKey, Alloc>& hs1, 
-                 const hash_multiset<Value, HashFcn, EqualKey, Alloc>& hs2) {
+template <class Value, class HashFcn, class EqualKey, class Alloc, class BucketPolicy>
+bool operator== (const hash_multiset<Value, HashFcn, EqualKey, Alloc, BucketPolicy>& hs1, 
+                 const hash_multiset<Value, HashFcn, EqualKey, Alloc, BucketPolicy>& hs2) {
     return hs1.rep == hs2.rep;
 }
 
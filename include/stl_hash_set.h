@@ -5,21 +5,30 @@
 #include "stl_hash_fun.h"
 #include "stl_functional.h"
 #include "stl_hashtable.h"
+#include "stl_flat_hashtable.h"
+#include "stl_swiss_hashtable.h"
 
 namespace msl {
 
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
+template <class Value, class HashFcn, class EqualKey, class Alloc, class Engine>
 class hash_set;
 
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
-bool operator== (const hash_set<Value, HashFcn, EqualKey, Alloc>& hs1, const hash_set<Value, HashFcn, EqualKey, Alloc>& hs2);
+template <class Value, class HashFcn, class EqualKey, class Alloc, class Engine>
+bool operator== (const hash_set<Value, HashFcn, EqualKey, Alloc, Engine>& hs1, const hash_set<Value, HashFcn, EqualKey, Alloc, Engine>& hs2);
 
-template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc>
+/**
+ * @brief 哈希集合
+ *
+ * @tparam Engine 底层哈希表: chained_hash_engine(默认, 链式 hashtable),
+ *         flat_hash_engine 或 swiss_hash_engine(开放定址, 插入可能使迭代器失效)
+ */
+template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc,
+          class Engine = chained_hash_engine>
 class hash_set {
 private:
-    typedef hashtable<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc> ht;
+    typedef typename Engine::template table<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc>::type ht;
     ht rep;
 
 public:
@@ -37,15 +46,19 @@ public:
 
     typedef typename ht::const_iterator iterator;
     typedef typename ht::const_iterator const_iterator;
+    typedef typename ht::allocator_type allocator_type;
 
     hasher hash_funct() const { return rep.hash_funct(); }
     key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
 
 public:
     hash_set() : rep(100, hasher(), key_equal()) {}
     explicit hash_set(size_type n) : rep(n, hasher(), key_equal()) {}
     hash_set(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
     hash_set(size_type n, const hasher& hf, const key_equal& eql) : rep(n, hf, eql) {}
+    hash_set(size_type n, const hasher& hf, const key_equal& eql, const allocator_type& a)
+        : rep(n, hf, eql, a) {}
 
     template <class InputIterator>
     hash_set(InputIterator first, InputIterator last) 
@@ -101,15 +114,9 @@ public:
     
     size_type erase(const key_type& key) { return rep.erase(key); }
     
-    void erase(iterator it) { 
-        typedef typename ht::iterator mutable_iterator;
-        if (it.cur)
-            rep.erase(mutable_iterator(it.cur, const_cast<ht*>(&rep))); 
-    }
-    
-    void erase(iterator first, iterator last) { 
-        rep.erase(first, last);
-    }
+    // 返回被删元素的下一个元素; 开放定址的引擎删除时会移动元素, 遍历时删除必须写成 it = erase(it)
+    iterator erase(iterator it) { return rep.erase(it); }
+    iterator erase(iterator first, iterator last) { return rep.erase(first, last); }
     
     void clear() { rep.clear(); }
 
@@ -120,15 +127,15 @@ public:
     size_type elems_in_bucket(size_type n) const { return rep.elems_in_bucket(n); }
 };
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
-inline void swap(hash_set<Value, HashFcn, EqualKey, Alloc>& hs1,
-                 hash_set<Value, HashFcn, EqualKey, Alloc>& hs2) {
+template <class Value, class HashFcn, class EqualKey, class Alloc, class Engine>
+inline void swap(hash_set<Value, HashFcn, EqualKey, Alloc, Engine>& hs1,
+                 hash_set<Value, HashFcn, EqualKey, Alloc, Engine>& hs2) {
     hs1.swap(hs2);
 }
 
-template <class Value, class HashFcn, class EqualKey, class Alloc>
-bool operator== (const hash_set<Value, HashFcn, EqualKey, Alloc>& hs1, 
-                 const hash_set<Value, HashFcn, EqualKey, Alloc>& hs2) {
+template <class Value, class HashFcn, class EqualKey, class Alloc, class Engine>
+bool operator== (const hash_set<Value, HashFcn, EqualKey, Alloc, Engine>& hs1, 
+                 const hash_set<Value, HashFcn, EqualKey, Alloc, Engine>& hs2) {
     return hs1.rep == hs2.rep;
 }
 
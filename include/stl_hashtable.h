@@ -4,6 +4,7 @@
 #include "stl_alloc.h"
 #include "stl_iterator.h"
 #include "stl_algo.h"
+#include "stl_algobase.h"
 #include "stl_vector.h"
 #include "stl_pair.h"
 #include "stl_hash_fun.h"
@@ -12,34 +13,45 @@
 namespace msl{
 
 //每个桶中的节点
-template<typename value>
+template<typename value, bool CacheHash = false>
 struct hash_node{
     hash_node* next;
     value val;
 };
+
+//保存完整哈希值的节点, 见 cached_hash_policy
+template<typename value>
+struct hash_node<value, true>{
+    hash_node* next;
+    size_t hash_code;
+    value val;
+};
 //声明
+struct prime_bucket_policy;
+
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc = alloc>
+         typename extractkey,class equalkey, typename Alloc = alloc,
+         class BucketPolicy = prime_bucket_policy>
 class hashtable;
 
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc>
+         typename extractkey,class equalkey, typename Alloc, class BucketPolicy>
 struct hashtable_iterator;
 
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc>
+         typename extractkey,class equalkey, typename Alloc, class BucketPolicy>
 struct hashtable_const_iterator;
 
 
 //迭代器
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc>
+         typename extractkey,class equalkey, typename Alloc, class BucketPolicy>
 struct hashtable_iterator{
-    typedef hashtable<value, key, hashfcn, extractkey, equalkey, Alloc> hashtable_type;
-    typedef hash_node<value> node;
-    typedef hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc> 
+    typedef hashtable<value, key, hashfcn, extractkey, equalkey, Alloc, BucketPolicy> hashtable_type;
+    typedef hash_node<value, BucketPolicy::cache_hash_code> node;
+    typedef hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy> 
         iterator;
-    typedef hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc> 
+    typedef hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy> 
         const_iterator;
 
     typedef forward_iterator_tag iterator_category;
@@ -56,7 +68,7 @@ struct hashtable_iterator{
         const node* old = cur;
         cur = cur->next;
         if(!cur){
-            size_type bucket = ht->bkt_num(old->val);
+            size_type bucket = ht->bkt_num_node(old);
             while(!cur && ++bucket < ht ->buckets.size())
                 cur = ht->buckets[bucket];
         }
@@ -84,13 +96,13 @@ struct hashtable_iterator{
 };
 
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc>
+         typename extractkey,class equalkey, typename Alloc, class BucketPolicy>
 struct hashtable_const_iterator{
-    typedef hashtable<value, key, hashfcn, extractkey, equalkey, Alloc> hashtable_type;
-    typedef hash_node<value> node;
-    typedef hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc> 
+    typedef hashtable<value, key, hashfcn, extractkey, equalkey, Alloc, BucketPolicy> hashtable_type;
+    typedef hash_node<value, BucketPolicy::cache_hash_code> node;
+    typedef hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy> 
         iterator;
-    typedef hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc> 
+    typedef hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy> 
         const_iterator;
 
     typedef forward_iterator_tag iterator_category;
@@ -107,7 +119,7 @@ struct hashtable_const_iterator{
         const node* old = cur;
         cur = cur->next;
         if(!cur){
-            size_type bucket = ht->bkt_num(old->val);
+            size_type bucket = ht->bkt_num_node(old);
             while(!cur && ++bucket < ht ->buckets.size())
                 cur = ht->buckets[bucket];
         }
@@ -155,6 +167,50 @@ inline unsigned long __stl_next_prime(unsigned long n){
     return pos == last ? *(last - 1) : *pos;
 }
 
+/**
+ * @brief hashtable 的桶策略: 桶数取素数, 用 hash % n 定位桶(默认)
+ *
+ * 对低位有规律的哈希值(hash<int> 这类恒等哈希)也能分布均匀, 代价是每次
+ * 查找, 插入和扩容都要做一次整数除法。
+ */
+struct prime_bucket_policy {
+    static const bool cache_hash_code = false;
+    static size_t next_size(size_t n) { return __stl_next_prime(n); }
+    static size_t max_size() { return __stl_prime_list[__stl_num_primes - 1]; }
+    static size_t index(size_t h, size_t n) { return h % n; }
+};
+
+/**
+ * @brief hashtable 的桶策略: 桶数取 2 的幂, 用斐波那契散列取哈希值的高位定位桶
+ *
+ * 定位只需要一次乘法和移位, 乘法同时打乱了恒等哈希的规律, 所以 hash<int>
+ * 也可以使用。
+ */
+struct pow2_bucket_policy {
+    static const bool cache_hash_code = false;
+    static size_t next_size(size_t n) {
+        size_t sz = 8;
+        while (sz < n && sz < max_size()) sz <<= 1;
+        return sz;
+    }
+    static size_t max_size() { return size_t(1) << (sizeof(size_t) * 8 - 1); }
+    static size_t index(size_t h, size_t n) {
+        return __fib_hash_index(h, sizeof(size_t) * 8 - __bit_ctz(n));
+    }
+};
+
+/**
+ * @brief 在 Policy 的基础上, 让每个节点保存键的完整哈希值
+ *
+ * 查找时先比较哈希值, 不相等的节点不再调用 equals; 扩容和迭代器前进时直接
+ * 使用保存的哈希值, 不再重新计算。每个节点多占一个 size_t, 适合 std::string
+ * 这类哈希和比较都比较昂贵的键。
+ */
+template <class Policy = prime_bucket_policy>
+struct cached_hash_policy : Policy {
+    static const bool cache_hash_code = true;
+};
+
 /**
  * @brief 哈希表
  * 
@@ -164,9 +220,11 @@ inline unsigned long __stl_next_prime(unsigned long n){
  * @tparam extractkey 提取键的函数类型
  * @tparam equalkey 键相等判断函数类型
  * @tparam alloc 分配器类型
+ * @tparam BucketPolicy 桶策略: prime_bucket_policy(默认) 或 pow2_bucket_policy,
+ *         用 cached_hash_policy 包装后节点中保存哈希值
  */
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc>
+         typename extractkey,class equalkey, typename Alloc, class BucketPolicy>
 class hashtable {
 public:
     typedef key key_type;
@@ -182,14 +240,15 @@ public:
     typedef const value_type& const_reference;
 
 private:
-    typedef hash_node<value> node;
+    typedef hash_node<value, BucketPolicy::cache_hash_code> node;
 public:
     typedef Alloc allocator_type;
-    allocator_type get_allocator() const { return allocator_type(); }
+    // 节点和桶数组使用同一个分配器, 分配器实例保存在 buckets 中
+    allocator_type get_allocator() const { return buckets.get_allocator(); }
 private:
     typedef simple_alloc<node, allocator_type> node_allocator;
-    node* get_node(){ return node_allocator::allocate(1); } 
-    void put_node(node* n){ node_allocator::deallocate(n); }
+    node* get_node(){ return node_allocator::allocate(buckets.get_allocator()); } 
+    void put_node(node* n){ node_allocator::deallocate(buckets.get_allocator(), n); }
 
 private:
     hasher hash;
@@ -203,19 +262,19 @@ public:
     key_equal key_eq() const { return equals; }
 
 public:
-    typedef hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc>
+    typedef hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy>
           iterator;
-  typedef hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc>
+  typedef hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy>
           const_iterator;
 
   friend struct
-  hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc>;
+  hashtable_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy>;
   friend struct
-  hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc>;
+  hashtable_const_iterator<value,key,hashfcn,extractkey,equalkey,Alloc,BucketPolicy>;
 
     size_type bucket_count() const { return buckets.size(); }
     size_type max_bucket_count() const 
-    { return __stl_prime_list[__stl_num_primes - 1]; }
+    { return BucketPolicy::max_size(); }
 
     size_type size() const { return num_elements; }
     bool empty() const { return num_elements == 0; }
@@ -227,17 +286,56 @@ public:
             construct(&n->val, val);
             return n;
         }
-        MYSTL_UNWIND(node_allocator::deallocate(n));
+        MYSTL_UNWIND(put_node(n));
     }
 
     void delete_node(node* n){
         destroy(&n->val);
-        node_allocator::deallocate(n);
+        put_node(n);
     }
 
+private:
+    typedef node_single<node, allocator_type> single_source;
+    typedef node_batch<node, allocator_type> batch_source;
+
+    // 从节点来源 src (node_single / node_batch) 取节点
+    template <class Source>
+    node* new_node(const value_type& val, Source& src) {
+        node* n = src.get();
+        n->next = 0;
+        MYSTL_TRY{
+            construct(&n->val, val);
+            return n;
+        }
+        MYSTL_UNWIND(src.put(n));
+    }
+
+    template <class InputIterator>
+    void insert_unique_range(InputIterator first, InputIterator last) {
+        const size_type n = range_size_hint(first, last);
+        resize(num_elements + n);
+        batch_source src(get_allocator(), n);
+        for (; first != last; ++first) {
+            if (n == 0) resize(num_elements + 1);
+            insert_unique_noresize(*first, src);
+        }
+    }
+
+    template <class InputIterator>
+    void insert_equal_range(InputIterator first, InputIterator last) {
+        const size_type n = range_size_hint(first, last);
+        resize(num_elements + n);
+        batch_source src(get_allocator(), n);
+        for (; first != last; ++first) {
+            if (n == 0) resize(num_elements + 1);
+            insert_equal_noresize(*first, src);
+        }
+    }
+public:
+
 private:
     size_type next_size(size_type n) const {
-        return __stl_next_prime(n);
+        return BucketPolicy::next_size(n);
     }
 
     void initialize_buckets(size_type n){
@@ -248,16 +346,27 @@ private:
     }
 
     void resize(size_type num_elements_hint);
-    pair<iterator, bool> insert_unique_noresize(const value_type& val);
-    iterator insert_equal_noresize(const value_type& val);
+    pair<iterator, bool> insert_unique_noresize(const value_type& val) {
+        single_source src(get_allocator());
+        return insert_unique_noresize(val, src);
+    }
+    iterator insert_equal_noresize(const value_type& val) {
+        single_source src(get_allocator());
+        return insert_equal_noresize(val, src);
+    }
+    template <class Source>
+    pair<iterator, bool> insert_unique_noresize(const value_type& val, Source& src);
+    template <class Source>
+    iterator insert_equal_noresize(const value_type& val, Source& src);
 
     void copy_from(const hashtable& ht); //不可直接使用,会造成内存泄漏
 public:
     hashtable(size_type n,
               const hashfcn& hf,
-              const equalkey& eql)
+              const equalkey& eql,
+              const allocator_type& a = allocator_type())
         : hash(hf), equals(eql), get_key(extractkey()),
-          num_elements(0)
+          buckets(a), num_elements(0)
     {
         initialize_buckets(n);
     }
@@ -265,9 +374,10 @@ public:
     hashtable(size_type n,
               const hashfcn& hf,
               const equalkey& eql,
-              const extractkey& getk)
+              const extractkey& getk,
+              const allocator_type& a = allocator_type())
         : hash(hf), equals(eql), get_key(getk),
-          num_elements(0)
+          buckets(a), num_elements(0)
     {
         initialize_buckets(n);
     }
@@ -320,51 +430,47 @@ public:
 
     template <class InputIterator>
     void insert_unique(InputIterator first, InputIterator last) {
-        for (; first != last; ++first)
-            insert_unique(*first);
+        insert_unique_range(first, last);
     }
 
     template <class InputIterator>
     void insert_equal(InputIterator first, InputIterator last) {
-        for (; first != last; ++first)
-            insert_equal(*first);
+        insert_equal_range(first, last);
     }
 
     void insert_unique(const value_type* first, const value_type* last) {
-        for (; first != last; ++first)
-            insert_unique(*first);
+        insert_unique_range(first, last);
     }
 
     void insert_equal(const value_type* first, const value_type* last) {
-        for (; first != last; ++first)
-            insert_equal(*first);
+        insert_equal_range(first, last);
     }
 
     iterator find(const key_type& k) {
-        size_type n = bkt_num_key(k);
-        node* first = buckets[n];
+        const size_t h = hash(k);
+        node* first = buckets[bkt_num_hash(h)];
         for(node* cur = first; cur; cur = cur->next){
-            if(equals(get_key(cur->val), k))
+            if(hash_matches(cur, h) && equals(get_key(cur->val), k))
                 return iterator(cur, this);
         }
         return end();
     }
 
     const_iterator find(const key_type& k) const {
-        size_type n = bkt_num_key(k);
-        node* first = buckets[n];
+        const size_t h = hash(k);
+        node* first = buckets[bkt_num_hash(h)];
         for(node* cur = first; cur; cur = cur->next){
-            if(equals(get_key(cur->val), k))
+            if(hash_matches(cur, h) && equals(get_key(cur->val), k))
                 return const_iterator(cur, const_cast<hashtable*>(this));
         }
         return end();
     }
 
     size_type count(const key_type& k) const {
-        const size_type bucket = bkt_num_key(k);
+        const size_t h = hash(k);
         size_type cnt = 0;
-        for(node* cur = buckets[bucket]; cur; cur = cur->next){
-            if(equals(get_key(cur->val), k))
+        for(node* cur = buckets[bkt_num_hash(h)]; cur; cur = cur->next){
+            if(hash_matches(cur, h) && equals(get_key(cur->val), k))
                 ++cnt;
         }
         return cnt;
@@ -385,7 +491,8 @@ public:
      * @return size_type 删除的元素数量
      */
     size_type erase(const key_type& k) {
-        const size_type bucket = bkt_num_key(k);
+        const size_t h = hash(k);
+        const size_type bucket = bkt_num_hash(h);
         node* first = buckets[bucket];
         size_type erased = 0;
 
@@ -393,7 +500,7 @@ public:
             node* cur = first;
             node* prev = 0;
             while (cur) {
-                if (equals(get_key(cur->val), k)) {
+                if (hash_matches(cur, h) && equals(get_key(cur->val), k)) {
                     if (prev) { //不是第一个节点
                         prev->next = cur->next;
                         delete_node(cur);
@@ -418,10 +525,13 @@ public:
      * @brief 删除指定迭代器指向的元素
      * 
      * @param it 要删除的迭代器
+     * @return iterator 被删元素的下一个元素
      */
-    void erase(iterator it) {
+    iterator erase(iterator it) {
+        iterator result = it;
         if (node* const p = it.cur) {
-            const size_type bucket = bkt_num(p->val);
+            ++result;
+            const size_type bucket = bkt_num_node(p);
             node* cur = buckets[bucket];
 
             if (cur == p) {
@@ -443,6 +553,7 @@ public:
                 }
             }
         }
+        return result;
     }
 
     /**
@@ -451,12 +562,20 @@ public:
      * @param first 范围的开始迭代器
      * @param last 范围的结束迭代器
      */
-    void erase(iterator first, iterator last) {
+    iterator erase(iterator first, iterator last) {
          //源码中实现更加复杂,以适应不同的情况,这里只是使用了最简单的方法
-        if (first.cur == last.cur) return;
         while (first != last) {
-            erase(first++);
+            first = erase(first);
         }
+        return last;
+    }
+
+    iterator erase(const const_iterator& it) {
+        return erase(iterator(it.cur, it.ht));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return erase(iterator(first.cur, first.ht), iterator(last.cur, last.ht));
     }
 
     iterator begin() {
@@ -491,39 +610,51 @@ public:
 
 
 private:
-    //以下四个函数用来索引bucket的序号
-    //注意: 前两个函数的参数是对象,后两个参数的参数是键
-    size_type bkt_num(const value_type& obj,size_t n) const {
-        return bkt_num_key(get_key(obj),n);
+    //以下函数用来索引bucket的序号
+    size_type bkt_num_hash(size_t h) const {
+        return BucketPolicy::index(h, bucket_count());
     }
 
-    size_type bkt_num(const value_type& obj) const {
-        return bkt_num_key(get_key(obj));
+    size_type bkt_num_node(const node* n) const {
+        return BucketPolicy::index(node_hash(n), bucket_count());
     }
 
     size_type bkt_num_key(const key_type& k) const {
-        return bkt_num_key(k,bucket_count());
+        return bkt_num_hash(hash(k));
     }
 
-    size_type bkt_num_key(const key_type& k,size_t n) const {
-        return hash(k) % n;
-    }
+    //节点中的哈希值: 只有 cached_hash_policy 的节点保存, 否则按需重新计算
+    typedef hash_node<value, true> cached_node;
+    typedef hash_node<value, false> plain_node;
+
+    size_t node_hash(const cached_node* n) const { return n->hash_code; }
+    size_t node_hash(const plain_node* n) const { return hash(get_key(n->val)); }
+
+    static void store_hash(cached_node* n, size_t h) { n->hash_code = h; }
+    static void store_hash(plain_node*, size_t) {}
+
+    static void copy_hash(cached_node* dst, const cached_node* src) { dst->hash_code = src->hash_code; }
+    static void copy_hash(plain_node*, const plain_node*) {}
+
+    //哈希值不同的节点一定不相等, 不需要调用 equals
+    static bool hash_matches(const cached_node* n, size_t h) { return n->hash_code == h; }
+    static bool hash_matches(const plain_node*, size_t) { return true; }
 
 };
 
 template<typename v, typename k, 
          typename hf, typename ex, 
-         typename eq, typename a>
-    void hashtable<v,k,hf,ex,eq,a>::resize(size_type num_elements_hint) {
+         typename eq, typename a, class bp>
+    void hashtable<v,k,hf,ex,eq,a,bp>::resize(size_type num_elements_hint) {
         const size_type old_size = bucket_count();
         if (num_elements_hint > old_size) {
             const size_type new_size = next_size(num_elements_hint);
             if(new_size > old_size) {
-                vector<node*,a> tmp(new_size, (node*)0);
+                vector<node*,a> tmp(new_size, (node*)0, buckets.get_allocator());
                 for(size_type bucket = 0; bucket < old_size; ++bucket) {
                     node* first = buckets[bucket];
                     while(first) {
-                        size_type new_idx = bkt_num(first->val,new_size);
+                        size_type new_idx = bp::index(node_hash(first), new_size);
                         buckets[bucket] = first->next;
                         first->next = tmp[new_idx];
                         tmp[new_idx] = first;
@@ -543,16 +674,19 @@ template<typename v, typename k,
  */
 template<typename v, typename k, 
          typename hf, typename ex, 
-         typename eq, typename a>
-pair<typename hashtable<v,k,hf,ex,eq,a>::iterator,bool>
-hashtable<v,k,hf,ex,eq,a>::insert_unique_noresize(const value_type& obj) {
-    const size_type bucket = bkt_num(obj);
+         typename eq, typename a, class bp>
+template <class Source>
+pair<typename hashtable<v,k,hf,ex,eq,a,bp>::iterator,bool>
+hashtable<v,k,hf,ex,eq,a,bp>::insert_unique_noresize(const value_type& obj, Source& src) {
+    const size_t h = hash(get_key(obj));
+    const size_type bucket = bkt_num_hash(h);
     node* first = buckets[bucket];
     for(node* cur = first; cur; cur = cur->next) {
-        if(equals(get_key(cur->val), get_key(obj)))
+        if(hash_matches(cur, h) && equals(get_key(cur->val), get_key(obj)))
             return pair<iterator,bool>(iterator(cur,this), false);
     }
-    node* tmp = new_node(obj);
+    node* tmp = new_node(obj, src);
+    store_hash(tmp, h);
     tmp->next = first;
     buckets[bucket] = tmp;
     ++num_elements;
@@ -561,21 +695,25 @@ hashtable<v,k,hf,ex,eq,a>::insert_unique_noresize(const value_type& obj) {
 
 template<typename v, typename k, 
          typename hf, typename ex, 
-         typename eq, typename a>
-typename hashtable<v,k,hf,ex,eq,a>::iterator
-hashtable<v,k,hf,ex,eq,a>::insert_equal_noresize(const value_type& obj) {
-    const size_type bucket = bkt_num(obj);
+         typename eq, typename a, class bp>
+template <class Source>
+typename hashtable<v,k,hf,ex,eq,a,bp>::iterator
+hashtable<v,k,hf,ex,eq,a,bp>::insert_equal_noresize(const value_type& obj, Source& src) {
+    const size_t h = hash(get_key(obj));
+    const size_type bucket = bkt_num_hash(h);
     node* first = buckets[bucket];
     for(node* cur = first; cur; cur = cur->next) {
-        if(equals(get_key(cur->val), get_key(obj))){
-            node* tmp = new_node(obj);
+        if(hash_matches(cur, h) && equals(get_key(cur->val), get_key(obj))){
+            node* tmp = new_node(obj, src);
+            store_hash(tmp, h);
             tmp->next = cur->next;
             cur->next = tmp;
             ++num_elements;
             return iterator(tmp,this);
         }
     }
-    node* tmp = new_node(obj);
+    node* tmp = new_node(obj, src);
+    store_hash(tmp, h);
     tmp->next = first;
     buckets[bucket] = tmp;
     ++num_elements;
@@ -584,14 +722,16 @@ hashtable<v,k,hf,ex,eq,a>::insert_equal_noresize(const value_type& obj) {
 
 template<typename v, typename k, 
          typename hf, typename ex, 
-         typename eq, typename a>
-void hashtable<v,k,hf,ex,eq,a>::clear() {
+         typename eq, typename a, class bp>
+void hashtable<v,k,hf,ex,eq,a,bp>::clear() {
+    batch_source src(get_allocator());
     for(size_type bucket = 0; bucket < bucket_count(); ++bucket) {
         node* first = buckets[bucket];
         while(first) {
             node* tmp = first;
             first = first->next;
-            delete_node(tmp);
+            destroy(&tmp->val);
+            src.put(tmp);
         }
         buckets[bucket] = 0;
     }
@@ -600,8 +740,8 @@ void hashtable<v,k,hf,ex,eq,a>::clear() {
 
 template<typename v, typename k, 
          typename hf, typename ex, 
-         typename eq, typename a>
-void hashtable<v,k,hf,ex,eq,a>::copy_from(const hashtable& ht) {
+         typename eq, typename a, class bp>
+void hashtable<v,k,hf,ex,eq,a,bp>::copy_from(const hashtable& ht) {
     buckets.clear();
     buckets.reserve(ht.bucket_count());
     buckets.insert(buckets.end(), ht.bucket_count(), (node*)0);
@@ -610,10 +750,12 @@ void hashtable<v,k,hf,ex,eq,a>::copy_from(const hashtable& ht) {
             node* first = ht.buckets[bucket];
             if(first) {
                 node* tmp = new_node(first->val);
+                copy_hash(tmp, first);
                 buckets[bucket] = tmp;
                 for(node* cur = first->next; cur; cur = cur->next) {
                     tmp->next = new_node(cur->val);
                     tmp = tmp->next;
+                    copy_hash(tmp, cur);
                 }
             }
         }
@@ -623,12 +765,55 @@ void hashtable<v,k,hf,ex,eq,a>::copy_from(const hashtable& ht) {
 }
 
 template<typename value, typename key, typename hashfcn,
-         typename extractkey,class equalkey, typename Alloc>
-inline void swap(hashtable<value, key, hashfcn, extractkey, equalkey, Alloc>& ht1,
-                 hashtable<value, key, hashfcn, extractkey, equalkey, Alloc>& ht2) {
+         typename extractkey,class equalkey, typename Alloc, class BucketPolicy>
+inline void swap(hashtable<value, key, hashfcn, extractkey, equalkey, Alloc, BucketPolicy>& ht1,
+                 hashtable<value, key, hashfcn, extractkey, equalkey, Alloc, BucketPolicy>& ht2) {
     ht1.swap(ht2);
 }
 
+// insert_equal 把键相等的元素放在同一条链上相邻的位置, 统计从 find(k) 开始的这一组中等于 val 的元素个数
+template<typename v, typename k, typename hf, typename ex, class eq, typename a, class bp>
+size_t __hashtable_count_value(const hashtable<v,k,hf,ex,eq,a,bp>& ht, const v& val) {
+    ex get_key;
+    eq equals = ht.key_eq();
+    size_t n = 0;
+    for (typename hashtable<v,k,hf,ex,eq,a,bp>::const_iterator it = ht.find(get_key(val));
+         it != ht.end() && equals(get_key(*it), get_key(val)); ++it) {
+        if (*it == val) ++n;
+    }
+    return n;
+}
+
+template<typename v, typename k, typename hf, typename ex, class eq, typename a, class bp>
+bool operator==(const hashtable<v,k,hf,ex,eq,a,bp>& ht1, const hashtable<v,k,hf,ex,eq,a,bp>& ht2) {
+    if (ht1.size() != ht2.size()) return false;
+    for (typename hashtable<v,k,hf,ex,eq,a,bp>::const_iterator it = ht1.begin(); it != ht1.end(); ++it) {
+        if (__hashtable_count_value(ht1, *it) != __hashtable_count_value(ht2, *it)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief hash_map/hash_set 的 Engine 参数: 使用链式的 hashtable
+ *
+ * 其他可选的引擎: flat_hash_engine (robin hood 开放定址), swiss_hash_engine
+ * (SwissTable 式分组探测)。引擎提供 table<value, key, hashfcn, extractkey,
+ * equalkey, Alloc>::type, 即 hashtable 的唯一键接口。
+ *
+ * @tparam BucketPolicy hashtable 的桶策略
+ */
+template <class BucketPolicy = prime_bucket_policy>
+struct basic_chained_hash_engine {
+    template<typename value, typename key, typename hashfcn,
+             typename extractkey, class equalkey, typename Alloc>
+    struct table {
+        typedef hashtable<value, key, hashfcn, extractkey, equalkey, Alloc, BucketPolicy> type;
+    };
+};
+
+// 默认引擎: 素数桶数的链式 hashtable
+typedef basic_chained_hash_engine<> chained_hash_engine;
+
 } // namespace msl
 
 
@@ -169,6 +169,35 @@ advance(InputIterator& i, Distance n) {
     __advance(i, n, category());
 }
 
+/**
+ * @brief 区间长度的提示值, 节点容器批量申请节点时使用
+ *
+ * 只有随机访问迭代器能以 O(1) 得到长度; 其他迭代器(包括 std 的迭代器)
+ * 返回 0 表示未知, 不为了得到长度而多遍历一次区间。
+ */
+template <typename Iterator,
+          bool = is_msl_iterator_tag<typename iterator_traits<Iterator>::iterator_category>::value>
+struct __range_size_hint {
+    static size_t get(Iterator first, Iterator last) {
+        return __get(first, last, iterator_category(first));
+    }
+private:
+    static size_t __get(Iterator, Iterator, input_iterator_tag) { return 0; }
+    static size_t __get(Iterator first, Iterator last, random_access_iterator_tag) {
+        return static_cast<size_t>(last - first);
+    }
+};
+
+template <typename Iterator>
+struct __range_size_hint<Iterator, false> {
+    static size_t get(Iterator, Iterator) { return 0; }
+};
+
+template <typename Iterator>
+inline size_t range_size_hint(Iterator first, Iterator last) {
+    return __range_size_hint<Iterator>::get(first, last);
+}
+
 template <typename ForwardIterator>
 inline ForwardIterator next
 (ForwardIterator it, 
@@ -79,7 +79,7 @@ struct __list_iterator : _iterator_base{
 };
 
 template<typename T,typename Alloc>
-class list_base{
+class list_base : public alloc_holder<Alloc> {
 public:
     typedef Alloc allocator_type;
     /**
@@ -87,9 +87,9 @@ public:
      * 
      * @return allocator_type 
      */
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return this->get_alloc(); }
 
-    list_base(const allocator_type&){
+    list_base(const allocator_type& a) : alloc_holder<Alloc>(a) {
         node_ = get_node();
         node_->next = node_;
         node_->prev = node_;
@@ -103,20 +103,21 @@ public:
     void clear();
 protected:
     typedef simple_alloc<__list_node<T>,Alloc> data_allocator;
-    __list_node<T>* get_node() { return data_allocator::allocate(); }
-    void put_node(__list_node<T>* p) { data_allocator::deallocate(p); }
+    __list_node<T>* get_node() { return data_allocator::allocate(this->get_alloc()); }
+    void put_node(__list_node<T>* p) { data_allocator::deallocate(this->get_alloc(), p); }
 protected:
     __list_node<T>* node_;
 };
 
 template<typename T,typename Alloc>
 void list_base<T,Alloc>::clear(){
+    node_batch<__list_node<T>, Alloc> src(this->get_alloc());
     __list_node<T>* cur = static_cast<__list_node<T>*>(node_->next);
     while (cur != (__list_node<T>*)node_) {
         __list_node<T>* tmp = cur;
         cur = static_cast<__list_node<T>*>(cur->next);
         destroy(&tmp->data);
-        put_node(tmp);
+        src.put(tmp);
     }
     node_->next = node_;
     node_->prev = node_;
@@ -154,6 +155,7 @@ protected:
     using base::node_;
     using base::get_node;
     using base::put_node;
+    using base::swap_alloc;
 
     link_type create_node(const_reference val = T()) {
         link_type p = get_node();
@@ -187,6 +189,24 @@ protected:
         put_node(p);
     }
 
+    typedef node_batch<__list_node<T>, Alloc> batch_source;
+
+    // 从 node_batch 取节点, 构造后挂到 pos 之前
+    void insert_from(batch_source& src, iterator pos, const_reference val) {
+        link_type p = src.get();
+        MYSTL_TRY{
+            construct(&p->data, val);
+        }
+        MYSTL_CATCH_ALL{
+            src.put(p);
+            MYSTL_RETHROW;
+        }
+        p->next = pos.node;
+        p->prev = pos.node->prev;
+        pos.node->prev->next = p;
+        pos.node->prev = p;
+    }
+
 
     /**
      * @brief 将[first, last)区间的元素移动到pos位置之前
@@ -220,8 +240,9 @@ public:
      * 
      * @param n 元素数量
      * @param value 元素值
+     * @param a 分配器
      */
-    list(size_type n, const_reference value) : base(allocator_type()) {
+    list(size_type n, const_reference value, const allocator_type& a = allocator_type()) : base(a) {
         insert(begin(), n, value);
     }
 
@@ -230,9 +251,10 @@ public:
      * 
      * @param first 迭代器开始
      * @param last 迭代器结束
+     * @param a 分配器
      */
     template <typename InputIterator, typename = typename msl::enable_if<!msl::is_integer<InputIterator>::Integral::value>::type>
-    list(InputIterator first, InputIterator last) : base(allocator_type()) {
+    list(InputIterator first, InputIterator last, const allocator_type& a = allocator_type()) : base(a) {
         insert(begin(), first, last);
     }
     
@@ -245,7 +267,7 @@ public:
         msl::swap(node_, x.node_);
     }
 
-    list(std::initializer_list<T> ilist) : base(allocator_type()) {
+    list(std::initializer_list<T> ilist, const allocator_type& a = allocator_type()) : base(a) {
         insert(begin(), ilist.begin(), ilist.end());
     }
     #endif
@@ -274,7 +296,10 @@ public:
     const_reference front() const { return *begin(); }
     reference back() { return *--end(); }
     const_reference back() const { return *--end(); }
-    void swap(list& x){msl::swap(node_, x.node_);}
+    void swap(list& x){
+        msl::swap(node_, x.node_);
+        swap_alloc(x);
+    }
 
     list& operator=(const list& x) {
         if (this != &x) {
@@ -286,7 +311,7 @@ public:
     #if MYSTL_CPP_VERSION >= 11
     list& operator=(list&& x) {
         clear();
-        msl::swap(node_, x.node_);
+        swap(x);
         return *this;
     }
 
@@ -372,8 +397,9 @@ public:
      * @param value 元素值
      */
     void insert(iterator pos, size_type n, const_reference value) {
+        batch_source src(this->get_alloc(), n);
         for (; n > 0; --n) {
-            insert(pos, value);
+            insert_from(src, pos, value);
         }
     }
     
@@ -387,8 +413,9 @@ public:
     template <typename InputIterator, 
     typename = typename msl::enable_if<!msl::is_integer<InputIterator>::Integral::value>::type>
     void insert(iterator pos, InputIterator first, InputIterator last) {
+        batch_source src(this->get_alloc(), range_size_hint(first, last));
         for (; first != last; ++first) {
-            insert(pos, *first);
+            insert_from(src, pos, *first);
         }
     }
 
@@ -698,7 +725,7 @@ public:
                 if (i == fill) ++fill;
             }
             for (int i = 1; i < fill; ++i) counter[i].merge(counter[i - 1]);
-            swap(counter[fill-1]);
+            splice(end(), counter[fill-1]); // 不用swap, 头节点必须留在本链表的分配器中
         }
     }
 
@@ -724,7 +751,7 @@ public:
                 if (i == fill) ++fill;
             }
             for (int i = 1; i < fill; ++i) counter[i].merge(counter[i - 1], comp);
-            swap(counter[fill-1]);
+            splice(end(), counter[fill-1]); // 不用swap, 头节点必须留在本链表的分配器中
         }
     }
     
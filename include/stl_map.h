@@ -44,10 +44,12 @@ public:
     typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;
+    typedef typename rep_type::allocator_type allocator_type;
 
     // allocation/deallocation
     map() : t(Compare()) {}
     explicit map(const Compare& comp) : t(comp) {}
+    map(const Compare& comp, const allocator_type& a) : t(comp, a) {}
 
     template <class InputIterator>
     map(InputIterator first, InputIterator last)
@@ -57,6 +59,10 @@ public:
     map(InputIterator first, InputIterator last, const Compare& comp)
         : t(comp) { t.insert_unique(first, last); }
 
+    template <class InputIterator>
+    map(InputIterator first, InputIterator last, const Compare& comp, const allocator_type& a)
+        : t(comp, a) { t.insert_unique(first, last); }
+
     map(const map<Key, T, Compare, Alloc>& x) : t(x.t) {}
     map<Key, T, Compare, Alloc>& operator=(const map<Key, T, Compare, Alloc>& x) {
         t = x.t;
@@ -65,6 +71,7 @@ public:
 
     // accessors:
     key_compare key_comp() const { return t.key_comp(); }
+    allocator_type get_allocator() const { return t.get_allocator(); }
     value_compare value_comp() const { return value_compare(t.key_comp()); }
     iterator begin() { return t.begin(); }
     const_iterator begin() const { return t.begin(); }
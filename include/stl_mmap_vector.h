@@ -0,0 +1,304 @@
+#ifndef MYSTL_MMAP_VECTOR_H
+#define MYSTL_MMAP_VECTOR_H
+
+#include "stl_config.h"
+
+#ifdef MYSTL_PLATFORM_LINUX
+
+#include "stl_algobase.h"
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace msl {
+
+enum mmap_open_mode {
+    mmap_read_only,     // 文件只读; 对元素的修改是进程私有的写时复制, 不会写回文件, 也不能改变大小
+    mmap_read_write     // 修改直接写回文件, 可以增长和收缩
+};
+
+/**
+ * @brief 以文件为存储区的 vector, 元素通过 mmap 直接映射
+ *
+ * 打开文件时只建立映射, 元素在第一次访问时由缺页中断按页载入, 不需要逐条读取和
+ * push_back。文件内容就是元素数组本身, 大小必须是 sizeof(T) 的整数倍。
+ *
+ * 读写模式下扩容用 ftruncate 扩展文件, 再用 mremap 扩大映射(可能移动, 之前的指针
+ * 和迭代器失效); 文件末尾可能留有预留的容量, close 时截断到实际大小。
+ *
+ * @tparam T 元素类型, 必须可以平凡复制
+ */
+template <typename T>
+class mmap_vector {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mmap_vector requires a trivially copyable element type");
+
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef msl::size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+private:
+    int fd_;
+    T* data_;
+    size_type size_;
+    size_type capacity_;
+    mmap_open_mode mode_;
+
+    static void fail(const char* what) {
+        MYSTL_THROW(std::runtime_error(std::string("mmap_vector: ") + what + ": " + strerror(errno)));
+    }
+
+    void require_writable() const {
+        if (mode_ != mmap_read_write) MYSTL_THROW(std::logic_error("mmap_vector: file is opened read-only"));
+    }
+
+    // 把文件和映射扩大到 n 个元素; 失败时文件恢复原来的大小(等于 capacity_ 个元素)
+    void remap(size_type n) {
+        const size_t old_bytes = capacity_ * sizeof(T);
+        const size_t new_bytes = n * sizeof(T);
+        if (ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) fail("ftruncate");
+        void* p;
+        if (data_) p = mremap(data_, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        else p = mmap(0, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            const int err = errno;
+            // 尽力而为: 这里已经要抛出异常, 恢复失败时多出的部分只能留在文件里
+            if (ftruncate(fd_, static_cast<off_t>(old_bytes)) != 0) {}
+            errno = err;
+            fail("mmap");
+        }
+        data_ = static_cast<T*>(p);
+        capacity_ = n;
+    }
+
+    void reset() {
+        fd_ = -1;
+        data_ = 0;
+        size_ = capacity_ = 0;
+        mode_ = mmap_read_only;
+    }
+
+public:
+    mmap_vector() { reset(); }
+
+    /**
+     * @brief 打开并映射文件
+     *
+     * @param path 文件路径, 读写模式下不存在时创建
+     * @param mode 打开方式
+     */
+    explicit mmap_vector(const char* path, mmap_open_mode mode = mmap_read_only) {
+        reset();
+        open(path, mode);
+    }
+
+    ~mmap_vector() { close(); }
+
+#ifdef MYSTL_HAS_MOVE_SEMANTICS
+    mmap_vector(mmap_vector&& x) noexcept
+        : fd_(x.fd_), data_(x.data_), size_(x.size_), capacity_(x.capacity_), mode_(x.mode_) {
+        x.reset();
+    }
+
+    mmap_vector& operator=(mmap_vector&& x) noexcept {
+        if (this != &x) {
+            close();
+            fd_ = x.fd_;
+            data_ = x.data_;
+            size_ = x.size_;
+            capacity_ = x.capacity_;
+            mode_ = x.mode_;
+            x.reset();
+        }
+        return *this;
+    }
+#endif
+
+    /**
+     * @brief 打开并映射文件, 之前打开的文件先关闭
+     *
+     * @throws std::runtime_error 打开或映射失败, 或者文件大小不是 sizeof(T) 的整数倍
+     */
+    void open(const char* path, mmap_open_mode mode = mmap_read_only) {
+        close();
+        int fd = ::open(path, mode == mmap_read_write ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd < 0) fail("open");
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail("fstat");
+        }
+        const size_t bytes = static_cast<size_t>(st.st_size);
+        if (bytes % sizeof(T) != 0) {
+            ::close(fd);
+            MYSTL_THROW(std::runtime_error("mmap_vector: file size is not a multiple of the element size"));
+        }
+        void* p = 0;
+        if (bytes) {
+            p = mmap(0, bytes, PROT_READ | PROT_WRITE,
+                     mode == mmap_read_write ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                fail("mmap");
+            }
+        }
+        fd_ = fd;
+        data_ = static_cast<T*>(p);
+        size_ = capacity_ = bytes / sizeof(T);
+        mode_ = mode;
+    }
+
+    /**
+     * @brief 解除映射并关闭文件, 读写模式下先把文件截断到实际大小
+     *
+     * 无论成功与否文件都会关闭。析构函数忽略返回值; 需要以异常的形式得到错误时,
+     * 在 close 之前调用 shrink_to_fit()。
+     *
+     * @return 截断失败时返回 false, errno 为失败原因。此时文件末尾残留预留的容量
+     *         (全为 0 的字节), 下次 open 时会被当作元素读入。
+     */
+    bool close() {
+        if (fd_ < 0) return true;
+        if (data_) munmap(data_, capacity_ * sizeof(T));
+        bool ok = true;
+        int err = 0;
+        if (mode_ == mmap_read_write && capacity_ != size_) {
+            ok = ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T))) == 0;
+            err = errno;
+        }
+        ::close(fd_);
+        reset();
+        if (!ok) errno = err;
+        return ok;
+    }
+
+    /**
+     * @brief 把修改同步写回文件
+     */
+    void sync() {
+        if (data_ && mode_ == mmap_read_write && msync(data_, capacity_ * sizeof(T), MS_SYNC) != 0)
+            fail("msync");
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+    bool writable() const { return mode_ == mmap_read_write; }
+
+    iterator begin() { return data_; }
+    const_iterator begin() const { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator end() const { return data_ + size_; }
+    pointer data() { return data_; }
+    const_pointer data() const { return data_; }
+
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    reference operator[](size_type n) { return data_[n]; }
+    const_reference operator[](size_type n) const { return data_[n]; }
+    reference at(size_type n) {
+        if (n >= size_) MYSTL_THROW(std::out_of_range("Index out of range"));
+        return data_[n];
+    }
+    const_reference at(size_type n) const {
+        if (n >= size_) MYSTL_THROW(std::out_of_range("Index out of range"));
+        return data_[n];
+    }
+    reference front() { return data_[0]; }
+    const_reference front() const { return data_[0]; }
+    reference back() { return data_[size_ - 1]; }
+    const_reference back() const { return data_[size_ - 1]; }
+
+    /**
+     * @brief 预留容量, 文件随之扩展
+     */
+    void reserve(size_type n) {
+        require_writable();
+        if (n > capacity_) remap(n);
+    }
+
+    void push_back(const T& value) {
+        require_writable();
+        if (size_ == capacity_) {
+            value_type tmp = value;     // value 可能位于映射中, remap 后失效
+            // 元素比一页还大时 page_elems 为 0, 至少扩展到 1 个元素
+            size_type page_elems = static_cast<size_type>(sysconf(_SC_PAGESIZE)) / sizeof(T);
+            if (page_elems == 0) page_elems = 1;
+            size_type n = capacity_ * 2;
+            if (n < page_elems) n = page_elems;
+            remap(n);
+            data_[size_++] = tmp;
+            return;
+        }
+        data_[size_++] = value;
+    }
+
+    void pop_back() { --size_; }
+
+    /**
+     * @brief 改变元素个数, 新增的元素赋值为 value
+     */
+    void resize(size_type n, const T& value = T()) {
+        require_writable();
+        const value_type tmp = value;
+        if (n > capacity_) remap(n);
+        for (size_type i = size_; i < n; ++i) data_[i] = tmp;
+        size_ = n;
+    }
+
+    void clear() {
+        require_writable();
+        size_ = 0;
+    }
+
+    /**
+     * @brief 把文件和映射收缩到实际大小
+     */
+    void shrink_to_fit() {
+        require_writable();
+        if (capacity_ == size_) return;
+        if (size_ == 0) {
+            munmap(data_, capacity_ * sizeof(T));
+            data_ = 0;
+            capacity_ = 0;
+            if (ftruncate(fd_, 0) != 0) fail("ftruncate");
+            return;
+        }
+        void* p = mremap(data_, capacity_ * sizeof(T), size_ * sizeof(T), MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) fail("mremap");
+        data_ = static_cast<T*>(p);
+        capacity_ = size_;
+        if (ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T))) != 0) fail("ftruncate");
+    }
+
+    void swap(mmap_vector& x) {
+        msl::swap(fd_, x.fd_);
+        msl::swap(data_, x.data_);
+        msl::swap(size_, x.size_);
+        msl::swap(capacity_, x.capacity_);
+        msl::swap(mode_, x.mode_);
+    }
+
+private:
+    mmap_vector(const mmap_vector&);
+    mmap_vector& operator=(const mmap_vector&);
+};
+
+} // namespace msl
+
+#endif // MYSTL_PLATFORM_LINUX
+
+#endif // MYSTL_MMAP_VECTOR_H
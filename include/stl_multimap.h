@@ -43,10 +43,12 @@ public:
     typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;
+    typedef typename rep_type::allocator_type allocator_type;
 
     // allocation/deallocation
     multimap() : t(Compare()) {}
     explicit multimap(const Compare& comp) : t(comp) {}
+    multimap(const Compare& comp, const allocator_type& a) : t(comp, a) {}
 
     template <class InputIterator>
     multimap(InputIterator first, InputIterator last)
@@ -56,6 +58,10 @@ public:
     multimap(InputIterator first, InputIterator last, const Compare& comp)
         : t(comp) { t.insert_equal(first, last); }
 
+    template <class InputIterator>
+    multimap(InputIterator first, InputIterator last, const Compare& comp, const allocator_type& a)
+        : t(comp, a) { t.insert_equal(first, last); }
+
     multimap(const multimap<Key, T, Compare, Alloc>& x) : t(x.t) {}
     multimap<Key, T, Compare, Alloc>& operator=(const multimap<Key, T, Compare, Alloc>& x) {
         t = x.t;
@@ -64,6 +70,7 @@ public:
 
     // accessors:
     key_compare key_comp() const { return t.key_comp(); }
+    allocator_type get_allocator() const { return t.get_allocator(); }
     value_compare value_comp() const { return value_compare(t.key_comp()); }
     iterator begin() { return t.begin(); }
     const_iterator begin() const { return t.begin(); }
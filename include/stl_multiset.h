@@ -30,10 +30,12 @@ public:
     typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;
+    typedef typename rep_type::allocator_type allocator_type;
 
     // allocation/deallocation
     multiset() : t(Compare()) {}
     explicit multiset(const Compare& comp) : t(comp) {}
+    multiset(const Compare& comp, const allocator_type& a) : t(comp, a) {}
 
     template <class InputIterator>
     multiset(InputIterator first, InputIterator last)
@@ -43,6 +45,10 @@ public:
     multiset(InputIterator first, InputIterator last, const Compare& comp)
         : t(comp) { t.insert_equal(first, last); }
 
+    template <class InputIterator>
+    multiset(InputIterator first, InputIterator last, const Compare& comp, const allocator_type& a)
+        : t(comp, a) { t.insert_equal(first, last); }
+
     multiset(const multiset<Key, Compare, Alloc>& x) : t(x.t) {}
     multiset<Key, Compare, Alloc>& operator=(const multiset<Key, Compare, Alloc>& x) {
         t = x.t;
@@ -51,6 +57,7 @@ public:
 
     // accessors:
     key_compare key_comp() const { return t.key_comp(); }
+    allocator_type get_allocator() const { return t.get_allocator(); }
     value_compare value_comp() const { return t.key_comp(); }
     iterator begin() const { return t.begin(); }
     iterator end() const { return t.end(); }
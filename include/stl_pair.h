@@ -1,6 +1,8 @@
 #ifndef MYSTL_PAIR_H
 #define MYSTL_PAIR_H
 
+#include "stl_type_traits.h"
+
 namespace msl {
 
 template <class T1, class T2>
@@ -18,6 +20,11 @@ struct pair {
     pair(const pair<U1, U2>& p) : first(p.first), second(p.second) {}
 };
 
+template <class T1, class T2>
+struct is_trivially_relocatable<pair<T1, T2> >
+    : public __bool_type<is_trivially_relocatable<T1>::value &&
+                         is_trivially_relocatable<T2>::value>::type {};
+
 template <class T1, class T2>
 inline bool operator==(const pair<T1, T2>& x, const pair<T1, T2>& y) {
     return x.first == y.first && x.second == y.second;
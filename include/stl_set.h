@@ -30,10 +30,12 @@ public:
     typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;
+    typedef typename rep_type::allocator_type allocator_type;
 
     // allocation/deallocation
     set() : t(Compare()) {}
     explicit set(const Compare& comp) : t(comp) {}
+    set(const Compare& comp, const allocator_type& a) : t(comp, a) {}
 
     template <class InputIterator>
     set(InputIterator first, InputIterator last)
@@ -43,6 +45,10 @@ public:
     set(InputIterator first, InputIterator last, const Compare& comp)
         : t(comp) { t.insert_unique(first, last); }
 
+    template <class InputIterator>
+    set(InputIterator first, InputIterator last, const Compare& comp, const allocator_type& a)
+        : t(comp, a) { t.insert_unique(first, last); }
+
     set(const set<Key, Compare, Alloc>& x) : t(x.t) {}
     set<Key, Compare, Alloc>& operator=(const set<Key, Compare, Alloc>& x) {
         t = x.t;
@@ -51,6 +57,7 @@ public:
 
     // accessors:
     key_compare key_comp() const { return t.key_comp(); }
+    allocator_type get_allocator() const { return t.get_allocator(); }
     value_compare value_comp() const { return t.key_comp(); }
     iterator begin() const { return t.begin(); }
     iterator end() const { return t.end(); }
@@ -0,0 +1,423 @@
+#ifndef MYSTL_SIMD_H
+#define MYSTL_SIMD_H
+
+#include "stl_config.h"
+#include "stl_type_traits.h"
+
+/*
+ * 连续区间上的 SIMD 查找/比较内核
+ *
+ * find, count, equal, mismatch, min_element, max_element 在迭代器是指向算术类型
+ * 的原生指针时, 改用这里的内核: 每次比较 16 字节(SSE2)或 32 字节(AVX2), 再用
+ * movemask 得到逐字节的比较结果。AVX2 在运行时检测, 不支持时退回 SSE2, 再退回
+ * 逐个比较的标量版本。定义 MYSTL_NO_SIMD 可以关闭这些内核。
+ *
+ * 整数按位比较, 和 == 的结果相同; 浮点数使用有序比较, NaN 与任何值都不相等,
+ * +0.0 与 -0.0 相等, 也和 == 一致。min/max 只对 8/16/32 位整数使用内核, 浮点数
+ * 在有 NaN 时的结果依赖比较顺序, 仍然逐个比较。
+ */
+#if !defined(MYSTL_NO_SIMD) && (defined(MYSTL_ARCH_X86_64) || defined(MYSTL_ARCH_X86)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#   define MYSTL_HAS_SIMD_KERNELS
+#   include <immintrin.h>
+#endif
+
+namespace msl {
+
+/*---------------------------------------------------------------------------*/
+/* 元素类型 -> 内核使用的比较方式 */
+
+struct __simd_lane_i8 {};
+struct __simd_lane_i16 {};
+struct __simd_lane_i32 {};
+struct __simd_lane_i64 {};
+struct __simd_lane_f32 {};
+struct __simd_lane_f64 {};
+
+struct __simd_s8 {};
+struct __simd_u8 {};
+struct __simd_s16 {};
+struct __simd_u16 {};
+struct __simd_s32 {};
+struct __simd_u32 {};
+
+template <size_t Size> struct __simd_int_lane;
+template <> struct __simd_int_lane<1> { typedef __simd_lane_i8 type; };
+template <> struct __simd_int_lane<2> { typedef __simd_lane_i16 type; };
+template <> struct __simd_int_lane<4> { typedef __simd_lane_i32 type; };
+template <> struct __simd_int_lane<8> { typedef __simd_lane_i64 type; };
+
+template <size_t Size, bool Signed> struct __simd_int_order { typedef false_type ordered; typedef void kind; };
+template <> struct __simd_int_order<1, true>  { typedef true_type ordered; typedef __simd_s8 kind; };
+template <> struct __simd_int_order<1, false> { typedef true_type ordered; typedef __simd_u8 kind; };
+template <> struct __simd_int_order<2, true>  { typedef true_type ordered; typedef __simd_s16 kind; };
+template <> struct __simd_int_order<2, false> { typedef true_type ordered; typedef __simd_u16 kind; };
+template <> struct __simd_int_order<4, true>  { typedef true_type ordered; typedef __simd_s32 kind; };
+template <> struct __simd_int_order<4, false> { typedef true_type ordered; typedef __simd_u32 kind; };
+
+/**
+ * @brief 元素类型能否使用 SIMD 内核
+ *
+ * supported 为 true_type 时可以用于 find/count/equal/mismatch, ordered 为 true_type
+ * 时还可以用于 min_element/max_element。未特化的类型都不使用内核。
+ */
+template <typename T>
+struct __simd_traits {
+    typedef false_type supported;
+    typedef false_type ordered;
+};
+
+template <typename T>
+struct __simd_int_traits {
+    typedef true_type supported;
+    typedef typename __simd_int_lane<sizeof(T)>::type lane;
+    typedef __simd_int_order<sizeof(T), (T(-1) < T(0))> order;
+    typedef typename order::ordered ordered;
+    typedef typename order::kind kind;
+};
+
+#ifdef MYSTL_HAS_SIMD_KERNELS
+template <> struct __simd_traits<char> : __simd_int_traits<char> {};
+template <> struct __simd_traits<signed char> : __simd_int_traits<signed char> {};
+template <> struct __simd_traits<unsigned char> : __simd_int_traits<unsigned char> {};
+template <> struct __simd_traits<wchar_t> : __simd_int_traits<wchar_t> {};
+template <> struct __simd_traits<short> : __simd_int_traits<short> {};
+template <> struct __simd_traits<unsigned short> : __simd_int_traits<unsigned short> {};
+template <> struct __simd_traits<int> : __simd_int_traits<int> {};
+template <> struct __simd_traits<unsigned int> : __simd_int_traits<unsigned int> {};
+template <> struct __simd_traits<long> : __simd_int_traits<long> {};
+template <> struct __simd_traits<unsigned long> : __simd_int_traits<unsigned long> {};
+#if MYSTL_CPP_VERSION >= 11
+template <> struct __simd_traits<long long> : __simd_int_traits<long long> {};
+template <> struct __simd_traits<unsigned long long> : __simd_int_traits<unsigned long long> {};
+template <> struct __simd_traits<char16_t> : __simd_int_traits<char16_t> {};
+template <> struct __simd_traits<char32_t> : __simd_int_traits<char32_t> {};
+#endif
+template <> struct __simd_traits<float> {
+    typedef true_type supported;
+    typedef false_type ordered;
+    typedef __simd_lane_f32 lane;
+};
+template <> struct __simd_traits<double> {
+    typedef true_type supported;
+    typedef false_type ordered;
+    typedef __simd_lane_f64 lane;
+};
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* 迭代器 -> 是否选用内核 */
+
+// 原生指针的元素类型, 其他迭代器为 void
+template <typename Iterator> struct __simd_pointer { typedef void value_type; };
+template <typename T> struct __simd_pointer<T*> { typedef T value_type; };
+template <typename T> struct __simd_pointer<const T*> { typedef T value_type; };
+
+template <typename T, typename U>
+struct __simd_same_value { typedef false_type type; typedef false_type ordered; };
+template <typename T>
+struct __simd_same_value<T, T> {
+    typedef typename __simd_traits<T>::supported type;
+    typedef typename __simd_traits<T>::ordered ordered;
+};
+
+// [first, last) 是指向 T 的原生指针区间, T 支持内核
+template <typename Iterator, typename T>
+struct __simd_find_ok
+    : __simd_same_value<typename __simd_pointer<Iterator>::value_type, T> {};
+
+// 两个区间都是指向同一种元素类型的原生指针
+template <typename Iterator1, typename Iterator2>
+struct __simd_range_ok
+    : __simd_same_value<typename __simd_pointer<Iterator1>::value_type,
+                        typename __simd_pointer<Iterator2>::value_type> {};
+
+// 单个原生指针区间
+template <typename Iterator>
+struct __simd_ordered_ok {
+    typedef typename __simd_range_ok<Iterator, Iterator>::ordered type;
+};
+
+/*---------------------------------------------------------------------------*/
+/* 标量版本: 不支持 SSE2 的 CPU 和没有内核的平台使用 */
+
+struct __simd_scalar {
+    template <typename T>
+    static const T* find(const T* first, const T* last, T value) {
+        while (first != last && !(*first == value)) ++first;
+        return first;
+    }
+
+    template <typename T>
+    static size_t count(const T* first, const T* last, T value) {
+        size_t n = 0;
+        for (; first != last; ++first)
+            if (*first == value) ++n;
+        return n;
+    }
+
+    template <typename T>
+    static size_t mismatch(const T* first1, const T* last1, const T* first2) {
+        const T* p = first1;
+        while (p != last1 && *p == *first2) {
+            ++p;
+            ++first2;
+        }
+        return static_cast<size_t>(p - first1);
+    }
+
+    // 区间不能为空
+    template <bool Max, typename T>
+    static T extreme(const T* first, const T* last) {
+        T result = *first;
+        while (++first != last)
+            if (Max ? result < *first : *first < result) result = *first;
+        return result;
+    }
+};
+
+#ifdef MYSTL_HAS_SIMD_KERNELS
+
+inline unsigned __simd_ctz(unsigned m) { return static_cast<unsigned>(__builtin_ctz(m)); }
+inline unsigned __simd_popcount(unsigned m) { return static_cast<unsigned>(__builtin_popcount(m)); }
+
+/*
+ * 各指令集的内核共用同一套算法, 由下面的宏展开到 __simd_sse2 和 __simd_avx2 中。
+ * 指令集结构体提供:
+ *   reg                     寄存器类型
+ *   width                   寄存器字节数
+ *   load/store              非对齐读写
+ *   splat(value, lane)      广播
+ *   eq(a, b, lane)          逐元素相等, 相等的元素全 1
+ *   mask(r)                 每字节最高位组成的掩码, 元素占 sizeof(T) 位
+ *   vmin/vmax(a, b, kind)   逐元素最小/最大值
+ */
+#define MYSTL_SIMD_ALGORITHMS(TARGET)                                                   \
+    template <typename T>                                                               \
+    static TARGET const T* find(const T* first, const T* last, T value) {               \
+        typedef typename __simd_traits<T>::lane lane;                                   \
+        const ptrdiff_t step = width / sizeof(T);                                       \
+        const reg v = splat(value, lane());                                             \
+        for (; last - first >= step; first += step) {                                   \
+            unsigned m = mask(eq(load(first), v, lane()));                              \
+            if (m) return first + __simd_ctz(m) / sizeof(T);                            \
+        }                                                                               \
+        return __simd_scalar::find(first, last, value);                                 \
+    }                                                                                   \
+                                                                                        \
+    template <typename T>                                                               \
+    static TARGET size_t count(const T* first, const T* last, T value) {                \
+        typedef typename __simd_traits<T>::lane lane;                                   \
+        const ptrdiff_t step = width / sizeof(T);                                       \
+        const reg v = splat(value, lane());                                             \
+        size_t bits = 0;                                                                \
+        for (; last - first >= step; first += step)                                     \
+            bits += __simd_popcount(mask(eq(load(first), v, lane())));                  \
+        return bits / sizeof(T) + __simd_scalar::count(first, last, value);             \
+    }                                                                                   \
+                                                                                        \
+    template <typename T>                                                               \
+    static TARGET size_t mismatch(const T* first1, const T* last1, const T* first2) {   \
+        typedef typename __simd_traits<T>::lane lane;                                   \
+        const ptrdiff_t step = width / sizeof(T);                                       \
+        const unsigned all = ~0u >> (32 - width);                                       \
+        const T* p = first1;                                                            \
+        for (; last1 - p >= step; p += step, first2 += step) {                          \
+            unsigned m = mask(eq(load(p), load(first2), lane())) ^ all;                 \
+            if (m) return static_cast<size_t>(p - first1) + __simd_ctz(m) / sizeof(T);  \
+        }                                                                               \
+        return static_cast<size_t>(p - first1) + __simd_scalar::mismatch(p, last1, first2); \
+    }                                                                                   \
+                                                                                        \
+    template <bool Max, typename T>                                                     \
+    static TARGET T extreme(const T* first, const T* last) {                            \
+        typedef typename __simd_traits<T>::kind kind;                                   \
+        const ptrdiff_t step = width / sizeof(T);                                       \
+        if (last - first < step) return __simd_scalar::extreme<Max>(first, last);       \
+        reg acc = load(first);                                                          \
+        for (first += step; last - first >= step; first += step)                        \
+            acc = Max ? vmax(acc, load(first), kind()) : vmin(acc, load(first), kind()); \
+        T lanes[width / sizeof(T)];                                                     \
+        store(lanes, acc);                                                              \
+        T result = __simd_scalar::extreme<Max>(lanes, lanes + step);                    \
+        if (first != last) {                                                            \
+            T tail = __simd_scalar::extreme<Max>(first, last);                          \
+            if (Max ? result < tail : tail < result) result = tail;                     \
+        }                                                                               \
+        return result;                                                                  \
+    }
+
+#define MYSTL_SIMD_SSE2 __attribute__((target("sse2")))
+
+struct __simd_sse2 {
+    typedef __m128i reg;
+    enum { width = 16 };
+
+    static MYSTL_SIMD_SSE2 reg load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+    static MYSTL_SIMD_SSE2 void store(void* p, reg r) { _mm_storeu_si128(static_cast<__m128i*>(p), r); }
+    static MYSTL_SIMD_SSE2 unsigned mask(reg r) { return static_cast<unsigned>(_mm_movemask_epi8(r)); }
+
+    template <typename T> static MYSTL_SIMD_SSE2 reg splat(T v, __simd_lane_i8) { return _mm_set1_epi8(static_cast<char>(v)); }
+    template <typename T> static MYSTL_SIMD_SSE2 reg splat(T v, __simd_lane_i16) { return _mm_set1_epi16(static_cast<short>(v)); }
+    template <typename T> static MYSTL_SIMD_SSE2 reg splat(T v, __simd_lane_i32) { return _mm_set1_epi32(static_cast<int>(v)); }
+    template <typename T> static MYSTL_SIMD_SSE2 reg splat(T v, __simd_lane_i64) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+    static MYSTL_SIMD_SSE2 reg splat(float v, __simd_lane_f32) { return _mm_castps_si128(_mm_set1_ps(v)); }
+    static MYSTL_SIMD_SSE2 reg splat(double v, __simd_lane_f64) { return _mm_castpd_si128(_mm_set1_pd(v)); }
+
+    static MYSTL_SIMD_SSE2 reg eq(reg a, reg b, __simd_lane_i8) { return _mm_cmpeq_epi8(a, b); }
+    static MYSTL_SIMD_SSE2 reg eq(reg a, reg b, __simd_lane_i16) { return _mm_cmpeq_epi16(a, b); }
+    static MYSTL_SIMD_SSE2 reg eq(reg a, reg b, __simd_lane_i32) { return _mm_cmpeq_epi32(a, b); }
+    // SSE2 没有 64 位比较: 两个 32 位半部分都相等
+    static MYSTL_SIMD_SSE2 reg eq(reg a, reg b, __simd_lane_i64) {
+        reg e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    static MYSTL_SIMD_SSE2 reg eq(reg a, reg b, __simd_lane_f32) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    static MYSTL_SIMD_SSE2 reg eq(reg a, reg b, __simd_lane_f64) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    // m 为全 1 的元素取 a, 否则取 b
+    static MYSTL_SIMD_SSE2 reg select(reg m, reg a, reg b) {
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+
+    // SSE2 只有 u8 和 s16 的 min/max, 其余用有符号比较拼出来; 无符号数先翻转符号位
+    static MYSTL_SIMD_SSE2 reg vmin(reg a, reg b, __simd_u8) { return _mm_min_epu8(a, b); }
+    static MYSTL_SIMD_SSE2 reg vmax(reg a, reg b, __simd_u8) { return _mm_max_epu8(a, b); }
+    static MYSTL_SIMD_SSE2 reg vmin(reg a, reg b, __simd_s16) { return _mm_min_epi16(a, b); }
+    static MYSTL_SIMD_SSE2 reg vmax(reg a, reg b, __simd_s16) { return _mm_max_epi16(a, b); }
+    static MYSTL_SIMD_SSE2 reg vmin(reg a, reg b, __simd_s8) { return select(_mm_cmpgt_epi8(a, b), b, a); }
+    static MYSTL_SIMD_SSE2 reg vmax(reg a, reg b, __simd_s8) { return select(_mm_cmpgt_epi8(a, b), a, b); }
+    static MYSTL_SIMD_SSE2 reg vmin(reg a, reg b, __simd_s32) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+    static MYSTL_SIMD_SSE2 reg vmax(reg a, reg b, __simd_s32) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+    static MYSTL_SIMD_SSE2 reg gt_u16(reg a, reg b) {
+        const reg bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        return _mm_cmpgt_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    }
+    static MYSTL_SIMD_SSE2 reg gt_u32(reg a, reg b) {
+        const reg bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    }
+    static MYSTL_SIMD_SSE2 reg vmin(reg a, reg b, __simd_u16) { return select(gt_u16(a, b), b, a); }
+    static MYSTL_SIMD_SSE2 reg vmax(reg a, reg b, __simd_u16) { return select(gt_u16(a, b), a, b); }
+    static MYSTL_SIMD_SSE2 reg vmin(reg a, reg b, __simd_u32) { return select(gt_u32(a, b), b, a); }
+    static MYSTL_SIMD_SSE2 reg vmax(reg a, reg b, __simd_u32) { return select(gt_u32(a, b), a, b); }
+
+    MYSTL_SIMD_ALGORITHMS(MYSTL_SIMD_SSE2)
+};
+
+#define MYSTL_SIMD_AVX2 __attribute__((target("avx2")))
+
+struct __simd_avx2 {
+    typedef __m256i reg;
+    enum { width = 32 };
+
+    static MYSTL_SIMD_AVX2 reg load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+    static MYSTL_SIMD_AVX2 void store(void* p, reg r) { _mm256_storeu_si256(static_cast<__m256i*>(p), r); }
+    static MYSTL_SIMD_AVX2 unsigned mask(reg r) { return static_cast<unsigned>(_mm256_movemask_epi8(r)); }
+
+    template <typename T> static MYSTL_SIMD_AVX2 reg splat(T v, __simd_lane_i8) { return _mm256_set1_epi8(static_cast<char>(v)); }
+    template <typename T> static MYSTL_SIMD_AVX2 reg splat(T v, __simd_lane_i16) { return _mm256_set1_epi16(static_cast<short>(v)); }
+    template <typename T> static MYSTL_SIMD_AVX2 reg splat(T v, __simd_lane_i32) { return _mm256_set1_epi32(static_cast<int>(v)); }
+    template <typename T> static MYSTL_SIMD_AVX2 reg splat(T v, __simd_lane_i64) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+    static MYSTL_SIMD_AVX2 reg splat(float v, __simd_lane_f32) { return _mm256_castps_si256(_mm256_set1_ps(v)); }
+    static MYSTL_SIMD_AVX2 reg splat(double v, __simd_lane_f64) { return _mm256_castpd_si256(_mm256_set1_pd(v)); }
+
+    static MYSTL_SIMD_AVX2 reg eq(reg a, reg b, __simd_lane_i8) { return _mm256_cmpeq_epi8(a, b); }
+    static MYSTL_SIMD_AVX2 reg eq(reg a, reg b, __simd_lane_i16) { return _mm256_cmpeq_epi16(a, b); }
+    static MYSTL_SIMD_AVX2 reg eq(reg a, reg b, __simd_lane_i32) { return _mm256_cmpeq_epi32(a, b); }
+    static MYSTL_SIMD_AVX2 reg eq(reg a, reg b, __simd_lane_i64) { return _mm256_cmpeq_epi64(a, b); }
+    static MYSTL_SIMD_AVX2 reg eq(reg a, reg b, __simd_lane_f32) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+    static MYSTL_SIMD_AVX2 reg eq(reg a, reg b, __simd_lane_f64) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+
+    static MYSTL_SIMD_AVX2 reg vmin(reg a, reg b, __simd_s8) { return _mm256_min_epi8(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmax(reg a, reg b, __simd_s8) { return _mm256_max_epi8(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmin(reg a, reg b, __simd_u8) { return _mm256_min_epu8(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmax(reg a, reg b, __simd_u8) { return _mm256_max_epu8(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmin(reg a, reg b, __simd_s16) { return _mm256_min_epi16(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmax(reg a, reg b, __simd_s16) { return _mm256_max_epi16(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmin(reg a, reg b, __simd_u16) { return _mm256_min_epu16(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmax(reg a, reg b, __simd_u16) { return _mm256_max_epu16(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmin(reg a, reg b, __simd_s32) { return _mm256_min_epi32(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmax(reg a, reg b, __simd_s32) { return _mm256_max_epi32(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmin(reg a, reg b, __simd_u32) { return _mm256_min_epu32(a, b); }
+    static MYSTL_SIMD_AVX2 reg vmax(reg a, reg b, __simd_u32) { return _mm256_max_epu32(a, b); }
+
+    MYSTL_SIMD_ALGORITHMS(MYSTL_SIMD_AVX2)
+};
+
+#undef MYSTL_SIMD_ALGORITHMS
+
+/**
+ * @brief 运行时可用的最高指令集: 2 为 AVX2, 1 为 SSE2, 0 为只能用标量版本
+ *
+ * 编译时已经打开的指令集不再检测。
+ */
+inline int __simd_level() {
+#if defined(__AVX2__)
+    return 2;
+#else
+    if (__builtin_cpu_supports("avx2")) return 2;
+#   if defined(__SSE2__)
+    return 1;
+#   else
+    return __builtin_cpu_supports("sse2") ? 1 : 0;
+#   endif
+#endif
+}
+
+#define MYSTL_SIMD_DISPATCH(CALL)                   \
+    switch (__simd_level()) {                       \
+    case 2: return __simd_avx2::CALL;               \
+    case 1: return __simd_sse2::CALL;               \
+    default: return __simd_scalar::CALL;            \
+    }
+
+#else
+
+#define MYSTL_SIMD_DISPATCH(CALL) return __simd_scalar::CALL;
+
+#endif // MYSTL_HAS_SIMD_KERNELS
+
+/*---------------------------------------------------------------------------*/
+/* 算法使用的入口 */
+
+template <typename T>
+inline const T* __simd_find(const T* first, const T* last, T value) {
+    MYSTL_SIMD_DISPATCH(find(first, last, value))
+}
+
+template <typename T>
+inline size_t __simd_count(const T* first, const T* last, T value) {
+    MYSTL_SIMD_DISPATCH(count(first, last, value))
+}
+
+// 返回第一个不相等元素的下标, 都相等时返回区间长度
+template <typename T>
+inline size_t __simd_mismatch(const T* first1, const T* last1, const T* first2) {
+    MYSTL_SIMD_DISPATCH(mismatch(first1, last1, first2))
+}
+
+// 区间不能为空
+template <typename T>
+inline T __simd_min_value(const T* first, const T* last) {
+    MYSTL_SIMD_DISPATCH(template extreme<false>(first, last))
+}
+
+template <typename T>
+inline T __simd_max_value(const T* first, const T* last) {
+    MYSTL_SIMD_DISPATCH(template extreme<true>(first, last))
+}
+
+#undef MYSTL_SIMD_DISPATCH
+
+} // namespace msl
+
+#endif // MYSTL_SIMD_H
@@ -0,0 +1,306 @@
+#ifndef MYSTL_SMALL_VECTOR_H
+#define MYSTL_SMALL_VECTOR_H
+
+#include "stl_config.h"
+#include "stl_vector.h"
+
+namespace msl {
+
+/**
+ * @brief small_vector 使用的配置器, 不超过内嵌缓冲区大小的请求直接返回缓冲区
+ *
+ * 缓冲区属于 small_vector 对象本身, 配置器只保存它的地址, 同一时刻只会被一个
+ * 存储区使用: small_vector 在存储区位于缓冲区时保证容量就是缓冲区大小, vector
+ * 只有在需要更大的容量时才会再次分配。超过缓冲区大小的请求交给 Alloc。
+ *
+ * @tparam Alloc 溢出到堆上时使用的配置器
+ */
+template <typename Alloc>
+class small_buffer_alloc {
+private:
+    void* buf_;
+    size_t bytes_;
+    Alloc alloc_;
+
+public:
+    small_buffer_alloc(void* buf, size_t bytes, const Alloc& a = Alloc())
+        : buf_(buf), bytes_(bytes), alloc_(a) {}
+
+    void* allocate(size_t n) const {
+        if (n <= bytes_) return buf_;
+        return alloc_.allocate(n);
+    }
+
+    void deallocate(void* p, size_t n) const {
+        if (p != buf_) alloc_.deallocate(p, n);
+    }
+
+    void* reallocate(void* p, size_t old_sz, size_t new_sz) const {
+        if (p != buf_) return alloc_.reallocate(p, old_sz, new_sz);
+        if (new_sz <= bytes_) return p;
+        void* result = alloc_.allocate(new_sz);
+        memcpy(result, p, old_sz);
+        return result;
+    }
+
+    const Alloc& base() const { return alloc_; }
+
+    // 只交换溢出用的配置器, 缓冲区仍然属于各自的 small_vector
+    void swap_base(small_buffer_alloc& x) {
+        Alloc tmp = alloc_;
+        alloc_ = x.alloc_;
+        x.alloc_ = tmp;
+    }
+};
+
+
+
+/**
+ * @brief 内嵌 N 个元素存储空间的 vector
+ *
+ * 元素不超过 N 个时存放在对象内部的缓冲区中, 不分配堆内存; 超过 N 个后
+ * 和 vector 一样在 Alloc 上分配。接口与 vector 相同。
+ *
+ * 存储区可能位于对象内部, 所以拷贝, 移动和交换都需要搬移元素, 不能只交换指针;
+ * small_vector 本身也不能按位搬移。vector 的 swap 和 shrink_to_fit 不了解内嵌
+ * 缓冲区, 所以以 protected 方式继承 vector, 不能通过 vector 的引用操作 small_vector。
+ *
+ * @tparam T 元素类型
+ * @tparam N 内嵌缓冲区能容纳的元素个数
+ * @tparam Alloc 溢出到堆上时使用的配置器，默认为 alloc
+ * @tparam Growth 扩容策略，默认为 vector_growth_double
+ */
+template <typename T, size_t N, typename Alloc = alloc, typename Growth = vector_growth_double>
+class small_vector : protected vector<T, small_buffer_alloc<Alloc>, Growth> {
+    static_assert(N > 0, "small_vector needs a non-empty inline buffer");
+
+private:
+    typedef vector<T, small_buffer_alloc<Alloc>, Growth> base;
+    typedef small_buffer_alloc<Alloc> buffer_alloc;
+
+public:
+    typedef typename base::value_type value_type;
+    typedef typename base::pointer pointer;
+    typedef typename base::const_pointer const_pointer;
+    typedef typename base::reference reference;
+    typedef typename base::const_reference const_reference;
+    typedef typename base::size_type size_type;
+    typedef typename base::difference_type difference_type;
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+    typedef typename base::reverse_iterator reverse_iterator;
+    typedef typename base::const_reverse_iterator const_reverse_iterator;
+    typedef typename base::allocator_type allocator_type;
+
+    using base::get_allocator;
+    using base::begin;
+    using base::end;
+    using base::cbegin;
+    using base::cend;
+    using base::rbegin;
+    using base::rend;
+    using base::crbegin;
+    using base::crend;
+    using base::size;
+    using base::capacity;
+    using base::empty;
+    using base::max_size;
+    using base::assign;
+#if MYSTL_CPP_VERSION >= 11
+    using base::emplace;
+    using base::emplace_back;
+#endif
+    using base::insert;
+    using base::append_range;
+    using base::operator[];
+    using base::at;
+    using base::front;
+    using base::back;
+    using base::data;
+    using base::push_back;
+    using base::pop_back;
+    using base::erase;
+    using base::reserve;
+    using base::resize;
+    using base::resize_default_init;
+    using base::resize_uninitialized;
+    using base::clear;
+
+    enum { inline_capacity = N };
+
+private:
+    alignas(T) unsigned char buf_[N * sizeof(T)];
+
+    T* buffer() { return reinterpret_cast<T*>(buf_); }
+    const T* buffer() const { return reinterpret_cast<const T*>(buf_); }
+    buffer_alloc make_alloc(const Alloc& a) { return buffer_alloc(buf_, sizeof(buf_), a); }
+
+    // 存储区位于缓冲区时, 把容量设为 N; 还没有存储区时使用缓冲区
+    void adopt_buffer() {
+        if (this->start_ == 0) this->start_ = this->finish_ = buffer();
+        if (this->start_ == buffer()) this->end_of_storage_ = buffer() + N;
+    }
+
+    // 接管 x 在堆上的存储区和分配它的配置器, x 回到空的内嵌缓冲区
+    void steal_heap(small_vector& x) {
+        this->start_ = x.start_;
+        this->finish_ = x.finish_;
+        this->end_of_storage_ = x.end_of_storage_;
+        x.start_ = x.finish_ = x.buffer();
+        x.end_of_storage_ = x.buffer() + N;
+        this->mutable_alloc().swap_base(x.mutable_alloc());
+    }
+
+    // 把 x 的元素移动到本对象, 本对象必须为空
+    void take(small_vector& x) {
+        if (!x.is_inline()) {
+            this->deallocate();
+            steal_heap(x);
+            return;
+        }
+        #if MYSTL_CPP_VERSION >= 11
+        this->finish_ = msl::uninitialized_move(x.start_, x.finish_, this->start_);
+        #else
+        this->finish_ = msl::uninitialized_copy(x.start_, x.finish_, this->start_);
+        #endif
+        x.clear();
+    }
+
+public:
+    small_vector(const Alloc& a = Alloc()) : base(make_alloc(a)) { adopt_buffer(); }
+
+    explicit small_vector(size_type n, const Alloc& a = Alloc())
+        : base(n, make_alloc(a)) { adopt_buffer(); }
+
+    small_vector(size_type n, const_reference value, const Alloc& a = Alloc())
+        : base(n, value, make_alloc(a)) { adopt_buffer(); }
+
+    template <typename InputIt,typename = typename msl::enable_if<!msl::is_integer<InputIt>::Integral::value>::type>
+    small_vector(InputIt first, InputIt last, const Alloc& a = Alloc())
+        : base(first, last, make_alloc(a)) { adopt_buffer(); }
+
+#if MYSTL_CPP_VERSION >= 11
+    small_vector(std::initializer_list<T> ilist, const Alloc& a = Alloc())
+        : base(ilist, make_alloc(a)) { adopt_buffer(); }
+#endif
+
+    small_vector(const small_vector& x)
+        : base(x, make_alloc(x.get_allocator().base())) { adopt_buffer(); }
+
+    small_vector& operator=(const small_vector& x) {
+        base::operator=(x);
+        return *this;
+    }
+
+#ifdef MYSTL_HAS_MOVE_SEMANTICS
+    small_vector(small_vector&& x) noexcept(is_nothrow_move_constructible<T>::value)
+        : base(make_alloc(x.get_allocator().base())) {
+        adopt_buffer();
+        take(x);
+    }
+
+    small_vector& operator=(small_vector&& x) noexcept(is_nothrow_move_constructible<T>::value) {
+        if (this != &x) {
+            this->clear();
+            take(x);
+        }
+        return *this;
+    }
+#endif
+
+#if MYSTL_CPP_VERSION >= 11
+    small_vector& operator=(std::initializer_list<T> ilist) {
+        this->assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+#endif
+
+    /**
+     * @brief 元素是否存放在内嵌缓冲区中
+     */
+    bool is_inline() const { return this->start_ == buffer(); }
+
+    /**
+     * @brief 释放多余的容量
+     *
+     * 元素不超过 N 个时搬回内嵌缓冲区并释放堆上的存储区。
+     */
+    void shrink_to_fit() {
+        if (is_inline()) return;
+        if (this->size() > N) {
+            base::shrink_to_fit();
+            return;
+        }
+        T* old_start = this->start_;
+        T* old_finish = this->finish_;
+        size_type old_capacity = this->capacity();
+        #if MYSTL_CPP_VERSION >= 11
+        T* new_finish = msl::uninitialized_move(old_start, old_finish, buffer());
+        #else
+        T* new_finish = msl::uninitialized_copy(old_start, old_finish, buffer());
+        #endif
+        msl::destroy(old_start, old_finish);
+        simple_alloc<T, buffer_alloc>::deallocate(this->get_alloc(), old_start, old_capacity);
+        this->start_ = buffer();
+        this->finish_ = new_finish;
+        this->end_of_storage_ = buffer() + N;
+    }
+
+    /**
+     * @brief 交换两个 small_vector 的内容
+     *
+     * 两者都在堆上时交换指针和配置器, 否则逐个搬移元素。
+     */
+    void swap(small_vector& x) {
+        if (this == &x) return;
+        if (!is_inline() && !x.is_inline()) {
+            msl::iter_swap(&this->start_, &x.start_);
+            msl::iter_swap(&this->finish_, &x.finish_);
+            msl::iter_swap(&this->end_of_storage_, &x.end_of_storage_);
+            this->mutable_alloc().swap_base(x.mutable_alloc());
+            return;
+        }
+        small_vector tmp(msl::move(x));
+        x = msl::move(*this);
+        *this = msl::move(tmp);
+    }
+};
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator==(const small_vector<T, N, Alloc, Growth>& x, const small_vector<T, N, Alloc, Growth>& y) {
+    return x.size() == y.size() && msl::equal(x.begin(), x.end(), y.begin());
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator!=(const small_vector<T, N, Alloc, Growth>& x, const small_vector<T, N, Alloc, Growth>& y) {
+    return !(x == y);
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator<(const small_vector<T, N, Alloc, Growth>& x, const small_vector<T, N, Alloc, Growth>& y) {
+    return msl::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator>(const small_vector<T, N, Alloc, Growth>& x, const small_vector<T, N, Alloc, Growth>& y) {
+    return y < x;
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator<=(const small_vector<T, N, Alloc, Growth>& x, const small_vector<T, N, Alloc, Growth>& y) {
+    return !(y < x);
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator>=(const small_vector<T, N, Alloc, Growth>& x, const small_vector<T, N, Alloc, Growth>& y) {
+    return !(x < y);
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline void swap(small_vector<T, N, Alloc, Growth>& x, small_vector<T, N, Alloc, Growth>& y) {
+    x.swap(y);
+}
+
+} // namespace msl
+
+#endif // MYSTL_SMALL_VECTOR_H
@@ -0,0 +1,537 @@
+#ifndef STL_SWISS_HASHTABLE_H
+#define STL_SWISS_HASHTABLE_H
+
+#include "stl_alloc.h"
+#include "stl_iterator.h"
+#include "stl_construct.h"
+#include "stl_algobase.h"
+#include "stl_pair.h"
+#include "stl_vector.h"
+#include "stl_hash_fun.h"
+#include "stl_functional.h"
+#include <cstring>
+
+#if defined(__SSE2__) && !defined(MYSTL_NO_SIMD)
+#   define MYSTL_SWISS_SSE2
+#   include <emmintrin.h>
+#endif
+
+namespace msl{
+
+// 控制字节: 空槽, 墓碑, 哨兵为负数, 占用的槽位存放哈希值的低 7 位
+enum {
+    __swiss_empty = -128,
+    __swiss_deleted = -2,
+    __swiss_sentinel = -1
+};
+
+/**
+ * @brief 一组 16 个控制字节, 一次比较得到逐槽位的位掩码
+ *
+ * 有 SSE2 时用一条 pcmpeqb + pmovmskb, 否则逐字节比较。
+ */
+struct __swiss_group {
+    enum { width = 16 };
+
+#ifdef MYSTL_SWISS_SSE2
+    __m128i ctrl;
+
+    explicit __swiss_group(const signed char* p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    unsigned match(signed char h2) const {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+
+    unsigned match_empty() const { return match(static_cast<signed char>(__swiss_empty)); }
+
+    // 空槽和墓碑都小于哨兵
+    unsigned match_empty_or_deleted() const {
+        return static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(__swiss_sentinel)), ctrl)));
+    }
+#else
+    const signed char* ctrl;
+
+    explicit __swiss_group(const signed char* p) : ctrl(p) {}
+
+    unsigned match(signed char h2) const {
+        unsigned m = 0;
+        for (int i = 0; i < width; ++i)
+            if (ctrl[i] == h2) m |= 1u << i;
+        return m;
+    }
+
+    unsigned match_empty() const { return match(static_cast<signed char>(__swiss_empty)); }
+
+    unsigned match_empty_or_deleted() const {
+        unsigned m = 0;
+        for (int i = 0; i < width; ++i)
+            if (ctrl[i] < __swiss_sentinel) m |= 1u << i;
+        return m;
+    }
+#endif
+};
+
+// 哈希值混合: 乘法把低位扩散到高位, 再把高半部分折回低位, 组号和 7 位标签都取自混合后的值
+inline size_t __swiss_mix(size_t h) {
+    const size_t golden = sizeof(size_t) == 8 ? size_t(11400714819323198485ull) : size_t(2654435769u);
+    h *= golden;
+    return h ^ (h >> (sizeof(size_t) * 4));
+}
+
+//迭代器: 同时指向槽位和它的控制字节, 控制字节数组末尾有哨兵
+template<typename value, typename Ref, typename Ptr>
+struct swiss_hashtable_iterator{
+    typedef swiss_hashtable_iterator<value, value&, value*> iterator;
+    typedef swiss_hashtable_iterator<value, const value&, const value*> const_iterator;
+    typedef swiss_hashtable_iterator<value, Ref, Ptr> self;
+
+    typedef forward_iterator_tag iterator_category;
+    typedef value value_type;
+    typedef ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef Ref reference;
+    typedef Ptr pointer;
+
+    value* cur;
+    const signed char* ctrl;
+
+    swiss_hashtable_iterator(value* c, const signed char* i) : cur(c), ctrl(i) {}
+    swiss_hashtable_iterator() : cur(0), ctrl(0) {}
+    // iterator 转换为 const_iterator; 对 iterator 本身这就是拷贝构造函数,
+    // 所以显式声明拷贝赋值, 否则隐式的拷贝赋值已被弃用(-Wdeprecated-copy)
+    swiss_hashtable_iterator(const iterator& it) : cur(it.cur), ctrl(it.ctrl) {}
+    self& operator=(const self&) = default;
+
+    reference operator*() const { return *cur; }
+    pointer operator->() const { return cur; }
+    self& operator++(){
+        do {
+            ++cur;
+            ++ctrl;
+        } while(*ctrl < __swiss_sentinel);
+        return *this;
+    }
+    self operator++(int){
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    bool operator==(const self& it) const { return cur == it.cur; }
+    bool operator!=(const self& it) const { return cur != it.cur; }
+};
+
+/**
+ * @brief SwissTable 式的开放定址哈希表
+ *
+ * 槽位按 16 个一组, 每个槽位有一个控制字节: 空槽, 墓碑, 或者哈希值的 7 位
+ * 标签。查找时一次比较一组 16 个控制字节, 只有标签相同的槽位才会比较键;
+ * 组内有空槽即可判定不存在, 所以未命中的查找通常不访问任何键。组之间按
+ * 三角数序列探测, 组数是 2 的幂, 能访问到所有组。
+ *
+ * 删除时如果所在组还有空槽, 说明从来没有探测序列经过这一组, 直接置为空槽;
+ * 否则留下墓碑。装载率(包括墓碑)达到 7/8 时扩容; 墓碑较多时按原大小重建。
+ *
+ * 插入不移动已有元素, 只有扩容会移动, 扩容使所有迭代器失效; 删除只使被删
+ * 元素的迭代器失效。元素的移动构造不应抛出异常。只支持键唯一的插入。
+ *
+ * @tparam value 元素类型
+ * @tparam key 键类型
+ * @tparam hashfcn 哈希函数类型
+ * @tparam extractkey 提取键的函数类型
+ * @tparam equalkey 键相等判断函数类型
+ * @tparam Alloc 分配器类型
+ */
+template<typename value, typename key, typename hashfcn,
+         typename extractkey, class equalkey, typename Alloc = alloc>
+class swiss_hashtable : protected alloc_holder<Alloc> {
+public:
+    typedef key key_type;
+    typedef value value_type;
+    typedef hashfcn hasher;
+    typedef equalkey key_equal;
+
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    typedef swiss_hashtable_iterator<value, value&, value*> iterator;
+    typedef swiss_hashtable_iterator<value, const value&, const value*> const_iterator;
+
+    typedef Alloc allocator_type;
+    allocator_type get_allocator() const { return this->get_alloc(); }
+
+private:
+    typedef simple_alloc<char, Alloc> data_allocator;
+
+    enum { group_width = __swiss_group::width };
+    static const size_type npos = size_type(-1);
+
+    hasher hash;
+    equalkey equals;
+    extractkey get_key;
+
+    value_type* slots;              // capacity 个槽位
+    signed char* ctrl;              // capacity + 1 个控制字节, ctrl[capacity] 为哨兵
+    size_type capacity;             // 组数 * 16
+    size_type num_elements;
+    size_type growth_left;          // 还能占用多少个空槽(墓碑不计)
+
+public:
+    hasher hash_funct() const { return hash; }
+    key_equal key_eq() const { return equals; }
+
+    size_type size() const { return num_elements; }
+    size_type max_size() const { return size_type(-1) / (sizeof(value_type) + 1) / 2; }
+    bool empty() const { return num_elements == 0; }
+
+    size_type bucket_count() const { return capacity; }
+    size_type max_bucket_count() const { return max_size(); }
+    size_type elems_in_bucket(size_type n) const { return ctrl[n] >= 0; }
+
+private:
+    static size_type max_load(size_type cap) { return cap - cap / 8; }
+
+    size_type group_mask() const { return capacity / group_width - 1; }
+
+    static size_type block_bytes(size_type n) { return n * sizeof(value_type) + n + 1; }
+
+    void allocate_slots(size_type cap) {
+        char* p = data_allocator::allocate(this->get_alloc(), block_bytes(cap));
+        slots = reinterpret_cast<value_type*>(p);
+        ctrl = reinterpret_cast<signed char*>(p + cap * sizeof(value_type));
+        memset(ctrl, __swiss_empty, cap);
+        ctrl[cap] = __swiss_sentinel;
+        capacity = cap;
+        num_elements = 0;
+        growth_left = max_load(cap);
+    }
+
+    void deallocate_slots() {
+        data_allocator::deallocate(this->get_alloc(), reinterpret_cast<char*>(slots), block_bytes(capacity));
+    }
+
+    // 容纳 n 个元素需要的槽位数
+    static size_type capacity_for(size_type n) {
+        size_type cap = group_width;
+        while (max_load(cap) < n) cap *= 2;
+        return cap;
+    }
+
+    void destroy_all() {
+        if (!type_traits<value_type>::is_trivially_destructible::value) {
+            for (size_type i = 0; i < capacity; ++i)
+                if (ctrl[i] >= 0) destroy(slots + i);
+        }
+    }
+
+    iterator make_iterator(size_type i) { return iterator(slots + i, ctrl + i); }
+    const_iterator make_iterator(size_type i) const { return const_iterator(slots + i, ctrl + i); }
+
+    static signed char h2(size_t m) { return static_cast<signed char>(m & 0x7f); }
+    size_type h1(size_t m) const { return (m >> 7) & group_mask(); }
+
+    size_type find_index(const key_type& k, size_t m) const {
+        const signed char tag = h2(m);
+        size_type g = h1(m);
+        for (size_type step = 1; ; g = (g + step++) & group_mask()) {
+            const size_type base = g * group_width;
+            __swiss_group grp(ctrl + base);
+            for (unsigned bits = grp.match(tag); bits; bits &= bits - 1) {
+                const size_type i = base + __bit_ctz(bits);
+                if (equals(get_key(slots[i]), k)) return i;
+            }
+            if (grp.match_empty()) return npos;
+        }
+    }
+
+    // 探测序列上第一个空槽或墓碑
+    size_type find_insert_slot(size_t m) const {
+        size_type g = h1(m);
+        for (size_type step = 1; ; g = (g + step++) & group_mask()) {
+            const size_type base = g * group_width;
+            unsigned bits = __swiss_group(ctrl + base).match_empty_or_deleted();
+            if (bits) return base + __bit_ctz(bits);
+        }
+    }
+
+    // 改为 cap 个槽位, 元素逐个移动到新数组, 墓碑随之清除
+    void rehash(size_type cap) {
+        value_type* old_slots = slots;
+        signed char* old_ctrl = ctrl;
+        const size_type old_capacity = capacity;
+        const size_type n = num_elements;
+        allocate_slots(cap);
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (old_ctrl[i] >= 0) {
+                const size_t m = __swiss_mix(hash(get_key(old_slots[i])));
+                const size_type j = find_insert_slot(m);
+                construct(slots + j, msl::move(old_slots[i]));
+                destroy(old_slots + i);
+                ctrl[j] = h2(m);
+            }
+        }
+        num_elements = n;
+        growth_left -= n;
+        data_allocator::deallocate(this->get_alloc(), reinterpret_cast<char*>(old_slots), block_bytes(old_capacity));
+    }
+
+    // 没有可用的空槽: 墓碑超过一半时原大小重建, 否则扩容为两倍
+    void rehash_for_insert() {
+        if (num_elements * 2 <= max_load(capacity)) rehash(capacity);
+        else rehash(capacity * 2);
+    }
+
+    void erase_index(size_type i) {
+        destroy(slots + i);
+        --num_elements;
+        if (__swiss_group(ctrl + (i & ~size_type(group_width - 1))).match_empty()) {
+            ctrl[i] = __swiss_empty;
+            ++growth_left;
+        } else {
+            ctrl[i] = __swiss_deleted;
+        }
+    }
+
+    void copy_from(const swiss_hashtable& ht);
+
+public:
+    swiss_hashtable(size_type n,
+                    const hashfcn& hf,
+                    const equalkey& eql,
+                    const allocator_type& a = allocator_type())
+        : alloc_holder<Alloc>(a), hash(hf), equals(eql), get_key(extractkey())
+    {
+        allocate_slots(capacity_for(n));
+    }
+
+    swiss_hashtable(size_type n,
+                    const hashfcn& hf,
+                    const equalkey& eql,
+                    const extractkey& getk,
+                    const allocator_type& a = allocator_type())
+        : alloc_holder<Alloc>(a), hash(hf), equals(eql), get_key(getk)
+    {
+        allocate_slots(capacity_for(n));
+    }
+
+    swiss_hashtable(const swiss_hashtable& ht)
+        : alloc_holder<Alloc>(ht.get_alloc()), hash(ht.hash), equals(ht.equals), get_key(ht.get_key)
+    {
+        copy_from(ht);
+    }
+
+    swiss_hashtable& operator=(const swiss_hashtable& ht){
+        if(this != &ht){
+            swiss_hashtable tmp(ht);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~swiss_hashtable() {
+        destroy_all();
+        deallocate_slots();
+    }
+
+    /**
+     * @brief 插入唯一元素
+     *
+     * @param val 要插入的元素
+     * @return pair<iterator, bool> 插入结果, 第一个元素是迭代器, 第二个元素是是否插入成功
+     */
+    pair<iterator, bool> insert_unique(const value_type& val) {
+        if (num_elements + 1 > max_load(capacity)) {
+            // 先查找再扩容: 键已存在时不必扩容(否则迭代器全部失效),
+            // 而且 val 可能就是表中的元素, 扩容会释放它
+            const size_type i = find_index(get_key(val), __swiss_mix(hash(get_key(val))));
+            if (i != npos)
+                return pair<iterator, bool>(make_iterator(i), false);
+            resize(num_elements + 1);
+        }
+        return insert_unique_noresize(val);
+    }
+
+    /**
+     * @brief 插入唯一元素, 装载率超过上限也不扩容
+     *
+     * 表中没有可用的空槽时仍然需要重建。
+     */
+    pair<iterator, bool> insert_unique_noresize(const value_type& val) {
+        const key_type& k = get_key(val);
+        const size_t m = __swiss_mix(hash(k));
+        const size_type found = find_index(k, m);
+        if (found != npos)
+            return pair<iterator, bool>(make_iterator(found), false);
+        size_type i = find_insert_slot(m);
+        if (growth_left == 0 && ctrl[i] == __swiss_empty) {
+            rehash_for_insert();
+            i = find_insert_slot(m);
+        }
+        construct(slots + i, val);
+        if (ctrl[i] == __swiss_empty) --growth_left;
+        ctrl[i] = h2(m);
+        ++num_elements;
+        return pair<iterator, bool>(make_iterator(i), true);
+    }
+
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last) {
+        resize(num_elements + range_size_hint(first, last));
+        for (; first != last; ++first)
+            insert_unique(*first);
+    }
+
+    iterator find(const key_type& k) {
+        const size_type i = find_index(k, __swiss_mix(hash(k)));
+        return i == npos ? end() : make_iterator(i);
+    }
+
+    const_iterator find(const key_type& k) const {
+        const size_type i = find_index(k, __swiss_mix(hash(k)));
+        return i == npos ? end() : make_iterator(i);
+    }
+
+    size_type count(const key_type& k) const {
+        return find_index(k, __swiss_mix(hash(k))) == npos ? 0 : 1;
+    }
+
+    void swap(swiss_hashtable& ht) {
+        this->swap_alloc(ht);
+        msl::swap(hash, ht.hash);
+        msl::swap(equals, ht.equals);
+        msl::swap(get_key, ht.get_key);
+        msl::swap(slots, ht.slots);
+        msl::swap(ctrl, ht.ctrl);
+        msl::swap(capacity, ht.capacity);
+        msl::swap(num_elements, ht.num_elements);
+        msl::swap(growth_left, ht.growth_left);
+    }
+
+    /**
+     * @brief 删除指定键的元素
+     *
+     * @param k 要删除的键
+     * @return size_type 删除的元素数量
+     */
+    size_type erase(const key_type& k) {
+        const size_type i = find_index(k, __swiss_mix(hash(k)));
+        if (i == npos) return 0;
+        erase_index(i);
+        return 1;
+    }
+
+    /**
+     * @brief 删除指定迭代器指向的元素
+     *
+     * @return iterator 下一个元素
+     */
+    iterator erase(const_iterator it) {
+        const size_type i = it.cur - slots;
+        erase_index(i);
+        return ++make_iterator(i);
+    }
+
+    /**
+     * @brief 删除指定迭代器范围内的元素
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last)
+            first = erase(first);
+        return make_iterator(last.cur - slots);
+    }
+
+    iterator begin() {
+        size_type i = 0;
+        while (ctrl[i] < __swiss_sentinel) ++i;
+        return make_iterator(i);
+    }
+
+    iterator end() { return make_iterator(capacity); }
+
+    const_iterator begin() const {
+        size_type i = 0;
+        while (ctrl[i] < __swiss_sentinel) ++i;
+        return make_iterator(i);
+    }
+
+    const_iterator end() const { return make_iterator(capacity); }
+
+    /**
+     * @brief 清空哈希表, 保留槽位数组
+     */
+    void clear() {
+        destroy_all();
+        memset(ctrl, __swiss_empty, capacity);
+        num_elements = 0;
+        growth_left = max_load(capacity);
+    }
+
+    /**
+     * @brief 保证容纳 num_elements_hint 个元素时不需要扩容
+     */
+    void resize(size_type num_elements_hint) {
+        if (num_elements_hint > max_load(capacity))
+            rehash(capacity_for(num_elements_hint));
+    }
+};
+
+template<typename v, typename k, typename hf, typename ex, typename eq, typename a>
+const typename swiss_hashtable<v,k,hf,ex,eq,a>::size_type swiss_hashtable<v,k,hf,ex,eq,a>::npos;
+
+// 槽位布局相同, 逐个复制
+template<typename v, typename k, typename hf, typename ex, typename eq, typename a>
+void swiss_hashtable<v,k,hf,ex,eq,a>::copy_from(const swiss_hashtable& ht) {
+    allocate_slots(ht.capacity);
+    size_type i = 0;
+    MYSTL_TRY{
+        for (; i < capacity; ++i) {
+            if (ht.ctrl[i] >= 0) construct(slots + i, ht.slots[i]);
+            ctrl[i] = ht.ctrl[i];
+        }
+        num_elements = ht.num_elements;
+        growth_left = ht.growth_left;
+    }
+    MYSTL_CATCH_ALL{
+        destroy_all();
+        deallocate_slots();
+        MYSTL_RETHROW;
+    }
+}
+
+template<typename v, typename k, typename hf, typename ex, typename eq, typename a>
+bool operator==(const swiss_hashtable<v,k,hf,ex,eq,a>& ht1, const swiss_hashtable<v,k,hf,ex,eq,a>& ht2) {
+    if (ht1.size() != ht2.size()) return false;
+    ex get_key;
+    for (typename swiss_hashtable<v,k,hf,ex,eq,a>::const_iterator it = ht1.begin(); it != ht1.end(); ++it) {
+        typename swiss_hashtable<v,k,hf,ex,eq,a>::const_iterator pos = ht2.find(get_key(*it));
+        if (pos == ht2.end() || !(*pos == *it)) return false;
+    }
+    return true;
+}
+
+template<typename value, typename key, typename hashfcn,
+         typename extractkey, class equalkey, typename Alloc>
+inline void swap(swiss_hashtable<value, key, hashfcn, extractkey, equalkey, Alloc>& ht1,
+                 swiss_hashtable<value, key, hashfcn, extractkey, equalkey, Alloc>& ht2) {
+    ht1.swap(ht2);
+}
+
+/**
+ * @brief hash_map/hash_set 的 Engine 参数: 使用 swiss_hashtable
+ */
+struct swiss_hash_engine {
+    template<typename value, typename key, typename hashfcn,
+             typename extractkey, class equalkey, typename Alloc>
+    struct table {
+        typedef swiss_hashtable<value, key, hashfcn, extractkey, equalkey, Alloc> type;
+    };
+};
+
+} // namespace msl
+
+#endif // STL_SWISS_HASHTABLE_H
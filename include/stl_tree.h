@@ -348,21 +348,21 @@ struct __rb_tree_iterator : public __rb_tree_base_iterator {
 };
 
 template <typename T, typename Alloc>
-class __rb_tree_base {
+class __rb_tree_base : public alloc_holder<Alloc> {
 public:
     typedef Alloc allocator_type;
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return this->get_alloc(); }
 
     __rb_tree_base(const allocator_type& a)
-    : header(0) {header = get_node();}
+    : alloc_holder<Alloc>(a), header(0) {header = get_node();}
     ~__rb_tree_base() { put_node(header); }
 
 protected:
     __rb_tree_node<T>* header;
     typedef simple_alloc<__rb_tree_node<T>, Alloc> node_allocator;
 
-    __rb_tree_node<T>* get_node() { return node_allocator::allocate(); }
-    void put_node(__rb_tree_node<T>* p) { node_allocator::deallocate(p); }
+    __rb_tree_node<T>* get_node() { return node_allocator::allocate(this->get_alloc()); }
+    void put_node(__rb_tree_node<T>* p) { node_allocator::deallocate(this->get_alloc(), p); }
 };
 
 
@@ -390,8 +390,15 @@ protected:
     using base::header;
     using base::get_node;
     using base::put_node;
+    using base::swap_alloc;
+
+public:
+    typedef typename base::allocator_type allocator_type;
 
 protected:
+    typedef node_single<__rb_tree_node<Value>, allocator_type> single_source;
+    typedef node_batch<__rb_tree_node<Value>, allocator_type> batch_source;
+
     link_type create_node(const value_type& x) {
         link_type tmp = get_node();
         MYSTL_TRY {
@@ -403,6 +410,19 @@ protected:
         return tmp;
     }
 
+    // 从节点来源 src (node_single / node_batch) 取节点
+    template <class Source>
+    link_type create_node(const value_type& x, Source& src) {
+        link_type tmp = src.get();
+        MYSTL_TRY {
+            construct(&tmp->value_field, x);
+        } MYSTL_CATCH_ALL {
+            src.put(tmp);
+            throw;
+        }
+        return tmp;
+    }
+
     link_type clone_node(link_type x) {
         link_type tmp = create_node(x->value_field);
         tmp->color = x->color;
@@ -416,6 +436,12 @@ protected:
         put_node(p);
     }
 
+    template <class Source>
+    void destroy_node(link_type p, Source& src) {
+        destroy(&p->value_field);
+        src.put(p);
+    }
+
 protected:
     link_type& root() const { return (link_type&)header->parent; }
     link_type& leftmost() const { return (link_type&)header->left; }
@@ -458,8 +484,8 @@ private:
     }
 
 public:
-    rb_tree(const Compare& comp = Compare()) 
-    : base(Alloc()), node_count(0), key_compare(comp) { 
+    rb_tree(const Compare& comp = Compare(), const allocator_type& a = allocator_type()) 
+    : base(a), node_count(0), key_compare(comp) { 
         empty_initialize(); 
     }
 
@@ -467,7 +493,7 @@ public:
         clear();
     }
 
-    rb_tree(const rb_tree& x) : base(Alloc()), node_count(0), key_compare(x.key_compare) {
+    rb_tree(const rb_tree& x) : base(x.get_allocator()), node_count(0), key_compare(x.key_compare) {
         empty_initialize();
         if (x.root() != 0) {
             root() = __copy(x.root(), header);
@@ -531,7 +557,8 @@ public:
     pair<const_iterator, const_iterator> equal_range(const Key& k) const;
 
     void clear(){
-        __erase(root());
+        batch_source src(this->get_alloc());
+        __erase(root(), src);
         root() = 0;
         leftmost() = header;
         rightmost() = header;
@@ -552,12 +579,15 @@ public:
         Compare tmp_comp = key_compare;
         key_compare = t.key_compare;
         t.key_compare = tmp_comp;
+
+        swap_alloc(t);
     }
 
     template <class InputIterator>
     void insert_unique(InputIterator first, InputIterator last) {
+        batch_source src(this->get_alloc(), range_size_hint(first, last));
         for (; first != last; ++first)
-            insert_unique(*first);
+            __insert_unique(*first, src);
     }
     
     /**
@@ -600,6 +630,13 @@ public:
      * @return pair<iterator, bool> 指向插入位置的迭代器和是否成功插入的标志
      */
     pair<iterator, bool> insert_unique(const value_type& v) {
+        single_source src(this->get_alloc());
+        return __insert_unique(v, src);
+    }
+
+private:
+    template <class Source>
+    pair<iterator, bool> __insert_unique(const value_type& v, Source& src) {
         link_type y = header;
         link_type x = root();
         bool comp = true;
@@ -611,12 +648,12 @@ public:
         iterator j = iterator(y);
         if (comp) {
             if (j == begin())
-                return pair<iterator, bool>(__insert(x, y, v), true);
+                return pair<iterator, bool>(__insert(x, y, v, src), true);
             else
                 --j;//回到前驱节点
         }
         if (key_compare(key(j.node), KeyOfValue()(v)))
-            return pair<iterator, bool>(__insert(x, y, v), true);
+            return pair<iterator, bool>(__insert(x, y, v, src), true);
         return pair<iterator, bool>(j, false);
         //例子：树中有 [10, 20] ，我们要插入 10 。
         //走到 20 时，发现 10 < 20 ，准备插在 20 的左边。
@@ -624,6 +661,19 @@ public:
         //但我们需要检查 20 的前一个数（也就是 10 ）是不是和新来的 10 相等。
     }
 
+    template <class Source>
+    iterator __insert_equal(const value_type& v, Source& src) {
+        link_type y = header;
+        link_type x = root();
+        while (x != 0) {
+            y = x;
+            x = key_compare(KeyOfValue()(v), key(x)) ? left(x) : right(x);
+        }
+        return __insert(x, y, v, src);
+    }
+
+public:
+
     /**
      * @brief 可以插入相等元素
      * 
@@ -631,13 +681,8 @@ public:
      * @return iterator 指向插入位置的迭代器
      */
     iterator insert_equal(const value_type& v) {
-        link_type y = header;
-        link_type x = root();
-        while (x != 0) {
-            y = x;
-            x = key_compare(KeyOfValue()(v), key(x)) ? left(x) : right(x);
-        }
-        return __insert(x, y, v);
+        single_source src(this->get_alloc());
+        return __insert_equal(v, src);
     }
 
     /**
@@ -648,8 +693,9 @@ public:
      */
     template<typename InputIterator>
     void insert_equal(InputIterator first, InputIterator last) {
+        batch_source src(this->get_alloc(), range_size_hint(first, last));
         for (; first != last; ++first)
-            insert_equal(*first);
+            __insert_equal(*first, src);
     }
 
     iterator insert_equal(iterator position, const value_type& v) {
@@ -711,7 +757,13 @@ private:
      * 
      * @param __x 要删除的节点
      */
-    void __erase(link_type __x);  //递归删除所有子节点
+    void __erase(link_type __x) {
+        single_source src(this->get_alloc());
+        __erase(__x, src);
+    }
+
+    template <class Source>
+    void __erase(link_type __x, Source& src);
 
     /**
      * @brief 递归插入节点
@@ -722,12 +774,18 @@ private:
      * @return iterator 指向插入位置的迭代器
      */
     iterator __insert(base_ptr x_, base_ptr y_, const value_type& v) {
+        single_source src(this->get_alloc());
+        return __insert(x_, y_, v, src);
+    }
+
+    template <class Source>
+    iterator __insert(base_ptr x_, base_ptr y_, const value_type& v, Source& src) {
         link_type x = (link_type)x_;
         link_type y = (link_type)y_;
         link_type z;
 
         if (y == header || x != 0 || key_compare(KeyOfValue()(v), key(y))) {
-            z = create_node(v);  // 创建新节点
+            z = create_node(v, src);  // 创建新节点
             left(y) = z;         // 挂在父节点的左边
             if (y == header) {   // 情况 A: 树为空，这是第一个节点
                 root() = z;      // header->parent 指向根节点
@@ -736,7 +794,7 @@ private:
                 leftmost() = z;  // 新节点比最小值还小，更新 header->left 指向新节点
             }
         } else {
-            z = create_node(v);// 创建新节点
+            z = create_node(v, src);// 创建新节点
             right(y) = z;       // 挂在父节点的右边
             if (y == rightmost())
                 rightmost() = z;
@@ -768,12 +826,13 @@ inline void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator posi
 }
 
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc >
+template <class Source>
 void rb_tree<Key, Value,KeyOfValue,Compare,Alloc>
-::__erase(link_type __x){
+::__erase(link_type __x, Source& src){
     while(__x != 0){
-        __erase(right(__x));
+        __erase(right(__x), src);
         link_type __y = left(__x);
-        destroy_node(__x);
+        destroy_node(__x, src);
         __x = __y;
     }
 }
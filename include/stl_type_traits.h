@@ -2,6 +2,9 @@
 #define MYSTL_TYPE_TRAITS_H
 
 #include "stl_config.h"
+#if MYSTL_CPP_VERSION >= 11
+#include <type_traits>
+#endif
 
 
 namespace msl {
@@ -21,6 +24,10 @@ struct enable_if<true, T> {
     typedef T type;
 };
 
+// 把编译期的 bool 值转换成 true_type / false_type
+template <bool B> struct __bool_type { typedef true_type type; };
+template <> struct __bool_type<false> { typedef false_type type; };
+
 template <typename T>
 struct type_traits {
     typedef false_type is_pod_type;
@@ -190,6 +197,75 @@ template<typename T> struct type_traits<T*> {
 
 
 
+/**
+ * @brief 判断一个类是否是空类(没有非静态数据成员)
+ *
+ * 用于空基类优化, T 必须是可以被继承的类类型。
+ */
+template <typename T>
+struct is_empty {
+private:
+    struct __first : public T { char c; };
+    struct __second { char c; };
+public:
+    static const bool value = sizeof(__first) == sizeof(__second);
+};
+
+
+
+/**
+ * @brief 类型的对齐要求, 相当于 alignof(T)
+ */
+template <typename T>
+struct alignment_of {
+#if MYSTL_CPP_VERSION >= 11
+    static const size_t value = alignof(T);
+#else
+private:
+    struct __helper { char c; T t; };
+public:
+    static const size_t value = sizeof(__helper) - sizeof(T);
+#endif
+};
+
+
+
+/**
+ * @brief 判断一个类型能否按位搬移
+ *
+ * 按位搬移是把对象的字节 memcpy 到新地址, 然后直接丢弃旧地址上的对象而不调用
+ * 析构函数, 效果等同于 "移动构造 + 析构"。POD 类型默认满足; 不保存指向自身的
+ * 指针的类(智能指针, 持有堆内存的句柄, msl::vector ...)通常也满足, 可以特化
+ * 本模板声明:
+ *
+ * namespace msl {
+ * template <> struct is_trivially_relocatable<my_handle> : public true_type {};
+ * }
+ *
+ * 注意 libstdc++ 的 std::string 对象内保存指向自身短字符串缓冲区的指针, 不能按位搬移。
+ */
+template <typename T>
+struct is_trivially_relocatable : public type_traits<T>::is_pod_type {};
+
+
+
+/**
+ * @brief 判断一个类型能否平凡默认构造
+ *
+ * type_traits 只对内置类型给出 true_type, C++11 起还接受编译器判断为平凡默认
+ * 构造的类型, 所以用户的 POD 结构体不需要再特化 type_traits。
+ */
+template <typename T>
+struct is_trivially_default_constructible
+#if MYSTL_CPP_VERSION >= 11
+    : public __bool_type<type_traits<T>::is_trivially_default_constructible::value ||
+                         std::is_trivially_default_constructible<T>::value>::type {};
+#else
+    : public type_traits<T>::is_trivially_default_constructible {};
+#endif
+
+
+
 /**
  * @brief 判断一个类型是否是整数类型
  * 
@@ -289,6 +365,29 @@ struct remove_reference<T&&> {
     typedef T type;
 };
 
+// 只用于不求值的表达式(noexcept, decltype)
+template <typename T>
+T&& __declval() noexcept;
+
+/**
+ * @brief T 的移动构造(没有移动构造函数时是复制构造)是否声明为 noexcept
+ */
+template <typename T>
+struct is_nothrow_move_constructible
+    : public __bool_type<noexcept(T(__declval<T>()))>::type {};
+
+/**
+ * @brief 容器重新分配存储区时, 旧元素是移动还是复制到新存储区
+ *
+ * 移动构造不会抛出异常, 或者可以按位搬移时为 true, 旧元素被移动;
+ * 否则复制旧元素, 复制中途抛出异常时旧存储区原封不动(强异常安全保证)。
+ * 可以为自己的类型特化本模板, 明确选择其中一种。
+ */
+template <typename T>
+struct relocate_with_move
+    : public __bool_type<is_nothrow_move_constructible<T>::value ||
+                         is_trivially_relocatable<T>::value>::type {};
+
 #endif
 
 } // namespace msl
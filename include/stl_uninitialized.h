@@ -138,6 +138,27 @@ template <typename Input_iterator, typename Forward_iterator>
 inline Forward_iterator uninitialized_move(Input_iterator first,Input_iterator last,Forward_iterator result) {
     return __uninitialized_move(first,last,result,msl::value_type(result));
 }
+
+// uninitialized_move_if_noexcept(): 按 relocate_with_move 选择移动还是复制
+template <typename Input_iterator, typename Forward_iterator>
+inline Forward_iterator __uninitialized_move_if_noexcept_aux(Input_iterator first,Input_iterator last,Forward_iterator result,true_type) {
+    return msl::uninitialized_move(first, last, result);
+}
+
+template <typename Input_iterator, typename Forward_iterator>
+inline Forward_iterator __uninitialized_move_if_noexcept_aux(Input_iterator first,Input_iterator last,Forward_iterator result,false_type) {
+    return msl::uninitialized_copy(first, last, result);
+}
+
+template <typename Input_iterator, typename Forward_iterator, typename T>
+inline Forward_iterator __uninitialized_move_if_noexcept(Input_iterator first,Input_iterator last,Forward_iterator result,T*) {
+    return __uninitialized_move_if_noexcept_aux(first,last,result,relocate_with_move<T>());
+}
+
+template <typename Input_iterator, typename Forward_iterator>
+inline Forward_iterator uninitialized_move_if_noexcept(Input_iterator first,Input_iterator last,Forward_iterator result) {
+    return __uninitialized_move_if_noexcept(first,last,result,msl::value_type(result));
+}
 #endif
 
 } // namespace msl
@@ -21,7 +21,7 @@ namespace msl {
 
 
 template <typename T, typename Alloc>
-class vector_base {
+class vector_base : public alloc_holder<Alloc> {
 protected:
     typedef simple_alloc<T, Alloc> data_allocator;
     typedef T* iterator;
@@ -32,23 +32,82 @@ protected:
     typedef Alloc allocator_type;
 
 public:
-    vector_base(const allocator_type& ) : 
+    vector_base(const allocator_type& a) : alloc_holder<Alloc>(a),
         start_(0), finish_(0), end_of_storage_(0) {}
 
-    explicit vector_base(msl::size_t n, const allocator_type& ) :
+    explicit vector_base(msl::size_t n, const allocator_type& a) : alloc_holder<Alloc>(a),
         start_(0), finish_(0), end_of_storage_(0) {
         if (n) {
-            start_ = data_allocator::allocate(n);
+            start_ = data_allocator::allocate(this->get_alloc(), n);
             finish_ = start_;
             end_of_storage_ = start_ + n;
         }
     }
     ~vector_base() {
         if (start_) {
-            data_allocator::deallocate(start_, end_of_storage_ - start_);
+            data_allocator::deallocate(this->get_alloc(), start_, end_of_storage_ - start_);
         }
     }
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return this->get_alloc(); }
+};
+
+
+
+/**
+ * @brief vector 的扩容策略
+ *
+ * next_capacity(size, required, elem_size) 返回存储区不够用时的新容量:
+ * size 是当前元素个数, required 是至少需要的元素个数, elem_size 是 sizeof(T)。
+ * round_to_size_class 为 true 时, vector 还会把新容量向上取整到配置器的
+ * 大小级别(见 alloc_good_size), 把本来就会浪费掉的尾部空间用起来。
+ */
+struct vector_growth_double {
+    enum { round_to_size_class = false };
+    static size_t next_capacity(size_t size, size_t required, size_t) {
+        size_t n = size ? size * 2 : 1;
+        return n < required ? required : n;
+    }
+};
+
+/**
+ * @brief 按 1.5 倍扩容
+ *
+ * 峰值内存更低; 而且连续几次扩容释放的旧存储区加起来能够容纳下一次的
+ * 新存储区, 配置器有机会复用它们。
+ */
+struct vector_growth_1_5 {
+    enum { round_to_size_class = false };
+    static size_t next_capacity(size_t size, size_t required, size_t) {
+        size_t n = size + size / 2;
+        if (n < size + 1) n = size + 1;
+        return n < required ? required : n;
+    }
+};
+
+/**
+ * @brief 按 2 倍扩容, 但每次最多增加 MaxIncrement 字节
+ *
+ * 小容器与 vector_growth_double 一样, 大缓冲区按固定步长增长, 不会一次
+ * 多占用近一倍的内存。
+ */
+template <size_t MaxIncrement = 64 * 1024 * 1024>
+struct vector_growth_capped {
+    enum { round_to_size_class = false };
+    static size_t next_capacity(size_t size, size_t required, size_t elem_size) {
+        size_t step = MaxIncrement / elem_size;
+        if (step == 0) step = 1;
+        size_t inc = size ? (size < step ? size : step) : 1;
+        size_t n = size + inc;
+        return n < required ? required : n;
+    }
+};
+
+/**
+ * @brief 在 Base 的基础上, 把容量取整到配置器的大小级别
+ */
+template <typename Base = vector_growth_double>
+struct vector_growth_size_class : public Base {
+    enum { round_to_size_class = true };
 };
 
 
@@ -61,13 +120,17 @@ public:
  * 
  * @tparam T 元素类型
  * @tparam Alloc 分配器类型，默认为 alloc
+ * @tparam Growth 扩容策略，默认为 vector_growth_double
  */
-template <typename T, typename Alloc = alloc>
+template <typename T, typename Alloc = alloc, typename Growth = vector_growth_double>
 class vector : protected vector_base<T, Alloc> {
     typedef vector_base<T, Alloc> base;
+protected:
     using base::start_;
     using base::finish_;
     using base::end_of_storage_;
+    using base::get_alloc;
+    using base::swap_alloc;
 public:
     typedef typename base::allocator_type allocator_type;
     allocator_type get_allocator() const { return base::get_allocator(); }
@@ -88,6 +151,101 @@ public:
 
 protected:
     typedef typename base::data_allocator data_allocator;
+    // 可以按位搬移的元素, 扩容时交给配置器的 reallocate, 有机会原地扩展;
+    // 插入和删除时用 memmove 挪动后面的元素, 不再逐个移动赋值
+    typedef is_trivially_relocatable<T> relocatable;
+
+    bool expand_storage(size_type new_capacity, true_type) {
+        const size_type n = size();
+        start_ = data_allocator::reallocate(get_alloc(), start_, capacity(), new_capacity);
+        finish_ = start_ + n;
+        end_of_storage_ = start_ + new_capacity;
+        return true;
+    }
+    bool expand_storage(size_type, false_type) { return false; }
+
+    static void reverse_range(iterator first, iterator last) {
+        while (first != last && first != --last) {
+            value_type tmp(msl::move(*first));
+            *first = msl::move(*last);
+            *last = msl::move(tmp);
+            ++first;
+        }
+    }
+
+    // 在 finish_ 之后默认初始化 n 个元素, 容量必须足够
+    void default_init_n(size_type n, true_type) { finish_ += n; }
+    void default_init_n(size_type n, false_type) {
+        iterator cur = finish_;
+        MYSTL_TRY {
+            for (; n > 0; --n, ++cur) new (static_cast<void*>(cur)) T;
+        }
+        MYSTL_CATCH_ALL {
+            msl::destroy(finish_, cur);
+            MYSTL_RETHROW;
+        }
+        finish_ = cur;
+    }
+
+    // 按位把 [position, finish_) 后移 n 个位置, 空出未构造的 [position, position + n)
+    // 没有需要移动的元素时不调用 memmove: 空 vector 的指针是空指针, 传给 memmove 是未定义行为
+    void open_gap(iterator position, size_type n) {
+        if (position != finish_)
+            memmove(static_cast<void*>(position + n), static_cast<const void*>(position),
+                    (finish_ - position) * sizeof(T));
+        finish_ += n;
+    }
+    // open_gap 的逆操作, [position, position + n) 必须已经析构或搬走
+    void close_gap(iterator position, size_type n) {
+        if (position + n != finish_)
+            memmove(static_cast<void*>(position), static_cast<const void*>(position + n),
+                    (finish_ - position - n) * sizeof(T));
+        finish_ -= n;
+    }
+
+    // 新元素已经构造在新存储区 [new_start + (position - start_), + n) 上, 把旧元素
+    // 搬到它们两侧(按 relocate_with_move 移动或复制), 然后释放旧存储区。
+    // 搬移时抛出异常则销毁并释放新存储区, 旧存储区保持不变。
+    void relocate_to(iterator new_start, size_type new_capacity, iterator position, size_type n) {
+        const size_type before = position - start_;
+        iterator new_finish = 0;
+        MYSTL_TRY {
+            #if MYSTL_CPP_VERSION >= 11
+            msl::uninitialized_move_if_noexcept(start_, position, new_start);
+            new_finish = new_start + before + n;
+            new_finish = msl::uninitialized_move_if_noexcept(position, finish_, new_finish);
+            #else
+            msl::uninitialized_copy(start_, position, new_start);
+            new_finish = new_start + before + n;
+            new_finish = msl::uninitialized_copy(position, finish_, new_finish);
+            #endif
+        }
+        MYSTL_CATCH_ALL {
+            if (new_finish) msl::destroy(new_start, new_finish);
+            else msl::destroy(new_start + before, new_start + before + n);
+            data_allocator::deallocate(get_alloc(), new_start, new_capacity);
+            MYSTL_RETHROW;
+        }
+        msl::destroy(start_, finish_);
+        data_allocator::deallocate(get_alloc(), start_, end_of_storage_ - start_);
+        start_ = new_start;
+        finish_ = new_finish;
+        end_of_storage_ = start_ + new_capacity;
+    }
+
+    // 按扩容策略计算至少容纳 required 个元素的新容量
+    size_type recommend(size_type required) const {
+        if (required > max_size()) MYSTL_THROW(std::length_error("vector"));
+        size_type n = Growth::next_capacity(size(), required, sizeof(T));
+        if (n > max_size() || n < required) n = max_size();
+        return round_capacity(n);
+    }
+
+    size_type round_capacity(size_type n) const {
+        if (!Growth::round_to_size_class) return n;
+        size_type rounded = alloc_good_size<Alloc>::get(n * sizeof(T)) / sizeof(T);
+        return rounded > n ? rounded : n;
+    }
 
     void insert_aux(iterator position, const_reference value);
     #if MYSTL_CPP_VERSION >= 11
@@ -113,14 +271,14 @@ protected:
 
     // allocate n elements and fill with value
     iterator allocate_and_fill(size_type n, const T& value) {
-        iterator result = data_allocator::allocate(n);
+        iterator result = data_allocator::allocate(get_alloc(), n);
         msl::uninitialized_fill_n(result, n, value);
         return result;
     }
 
     void deallocate(){
         if(start_){
-            data_allocator::deallocate(start_, end_of_storage_ - start_);
+            data_allocator::deallocate(get_alloc(), start_, end_of_storage_ - start_);
         }
     }
 public:
@@ -160,6 +318,18 @@ public:
         finish_ = msl::uninitialized_fill_n(start_, n, value);
     }
 
+    /**
+     * @brief 拷贝构造函数
+     * 
+     * 创建一个与其他 vector 内容相同的 vector, 使用 other 的分配器。
+     * 
+     * @param other 要拷贝的 vector
+     */
+    vector(const vector& other) :
+     base(other.size(), other.get_allocator()) {
+        finish_ = msl::uninitialized_copy(other.begin(), other.end(), start_);
+    }
+
     /**
      * @brief 拷贝构造函数
      * 
@@ -168,7 +338,7 @@ public:
      * @param other 要拷贝的 vector
      * @param alloc 分配器
      */
-    vector(const vector& other, const allocator_type& alloc = allocator_type()) :
+    vector(const vector& other, const allocator_type& alloc) :
      base(other.size(), alloc) {
         finish_ = msl::uninitialized_copy(other.begin(), other.end(), start_);
     }
@@ -230,10 +400,12 @@ public:
     vector& operator=(vector&& other) noexcept {
         if (this != &other) {
             clear();
+            deallocate();
             start_ = other.start_;
             finish_ = other.finish_;
             end_of_storage_ = other.end_of_storage_;
             other.start_ = other.finish_ = other.end_of_storage_ = 0;
+            swap_alloc(other);
         }
         return *this;
     }
@@ -274,6 +446,10 @@ private:
     void assign_range(ForwardIt first, ForwardIt last, msl::forward_iterator_tag);
     template <typename RandomIt>
     void assign_range(RandomIt first, RandomIt last, msl::random_access_iterator_tag);
+    template <typename InputIt>
+    void range_insert(iterator position, InputIt first, InputIt last, msl::input_iterator_tag);
+    template <typename ForwardIt>
+    void range_insert(iterator position, ForwardIt first, ForwardIt last, msl::forward_iterator_tag);
     
 
 public:
@@ -441,6 +617,40 @@ public:
      */
     void insert(iterator position,const_iterator first,const_iterator last);
 
+    /**
+     * @brief 在指定位置插入任意迭代器范围内的元素
+     *
+     * 前向迭代器先计算出元素个数, 最多只扩容一次; 输入迭代器的范围大小未知,
+     * 按扩容策略几何增长。
+     *
+     * @param position 插入位置
+     * @param first 范围起始迭代器
+     * @param last 范围结束迭代器
+     */
+    template <typename InputIt,typename = typename msl::enable_if<!msl::is_integer<InputIt>::Integral::value>::type>
+    void insert(iterator position, InputIt first, InputIt last) {
+        typedef typename msl::iterator_traits<InputIt>::iterator_category Cat;
+        static_assert(msl::is_msl_iterator_tag<Cat>::value, "must use msl iterator");
+        range_insert(position, first, last, Cat());
+    }
+
+    /**
+     * @brief 在末尾追加范围 [first, last) 内的元素
+     *
+     * @param first 范围起始迭代器
+     * @param last 范围结束迭代器
+     */
+    template <typename InputIt>
+    void append_range(InputIt first, InputIt last) { insert(end(), first, last); }
+
+    /**
+     * @brief 在末尾追加一个容器(任何提供 begin()/end() 的范围)中的全部元素
+     *
+     * @param r 要追加的范围
+     */
+    template <typename Range>
+    void append_range(const Range& r) { insert(end(), r.begin(), r.end()); }
+
     #if MYSTL_CPP_VERSION >= 11
     /**
      * @brief 在指定位置插入初始化列表中的元素
@@ -592,6 +802,11 @@ public:
      * @return iterator 指向被移除元素之后的元素的迭代器
      */
     iterator erase(iterator first,iterator last){
+        if (relocatable::value) {
+            msl::destroy(first, last);
+            close_gap(first, last - first);
+            return first;
+        }
         iterator i = msl::copy(last,finish_,first);
         msl::destroy(i,finish_);
         finish_ = finish_ - (last - first);
@@ -605,6 +820,11 @@ public:
      * @return iterator 指向被移除元素之后的元素的迭代器
      */
     iterator erase(iterator position){
+        if (relocatable::value) {
+            msl::destroy(position);
+            close_gap(position, 1);
+            return position;
+        }
         if(position + 1 != finish_)
              msl::copy(position + 1,finish_,position);
              --finish_;
@@ -619,14 +839,11 @@ public:
      */
     void reserve(size_type new_capacity) {
         if (new_capacity > capacity()) {
-            size_type old_size = size();
-            iterator new_start = data_allocator::allocate(new_capacity);
-            iterator new_finish = msl::uninitialized_copy(start_, finish_, new_start);
-            msl::destroy(start_, finish_);
-            data_allocator::deallocate(start_, end_of_storage_ - start_);
-            start_ = new_start;
-            finish_ = new_finish;
-            end_of_storage_ = start_ + new_capacity;
+            if (new_capacity > max_size()) MYSTL_THROW(std::length_error("vector::reserve"));
+            new_capacity = round_capacity(new_capacity);
+            if (expand_storage(new_capacity, relocatable())) return;
+            iterator new_start = data_allocator::allocate(get_alloc(), new_capacity);
+            relocate_to(new_start, new_capacity, finish_, 0);
         }
     }
 
@@ -646,6 +863,39 @@ public:
         }
     }
 
+    /**
+     * @brief 改变容器大小, 新增的元素默认初始化
+     *
+     * 与 resize 不同, 新增元素执行默认初始化(new (p) T)而不是值初始化:
+     * 平凡默认构造的类型(int, char, POD 结构体...)不会被清零, 只分配内存,
+     * 适合随后马上被 read 或解码结果整体覆盖的缓冲区。
+     *
+     * @param new_size 新大小
+     */
+    void resize_default_init(size_type new_size) {
+        if (new_size < size()) {
+            msl::destroy(start_ + new_size, finish_);
+            finish_ = start_ + new_size;
+        } else if (new_size > size()) {
+            // 按扩容策略增长, 反复 resize_default_init(size() + k) 均摊 O(1)
+            if (new_size > capacity()) reserve(recommend(new_size));
+            default_init_n(new_size - size(), is_trivially_default_constructible<T>());
+        }
+    }
+
+    /**
+     * @brief 改变容器大小, 新增的元素不做初始化
+     *
+     * 只能用于平凡默认构造的类型, 调用者负责在读取之前写入新增的元素。
+     *
+     * @param new_size 新大小
+     */
+    void resize_uninitialized(size_type new_size) {
+        static_assert(is_trivially_default_constructible<T>::value,
+                      "resize_uninitialized requires a trivially default constructible type");
+        resize_default_init(new_size);
+    }
+
     /**
      * @brief 清空容器
      */
@@ -662,26 +912,55 @@ public:
         msl::iter_swap(&start_, &other.start_);
         msl::iter_swap(&finish_, &other.finish_);
         msl::iter_swap(&end_of_storage_, &other.end_of_storage_);
+        swap_alloc(other);
     }
 
 };
  
-template<typename T,typename Alloc>
-void vector<T,Alloc>::insert_aux(iterator position, const_reference value) {
-    if (finish_ != end_of_storage_) {
+// vector 只保存指向堆上存储区的指针, 可以按位搬移
+template <typename T, typename Alloc, typename Growth>
+struct is_trivially_relocatable<vector<T, Alloc, Growth> > : public true_type {};
+
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::insert_aux(iterator position, const_reference value) {
+    if (finish_ != end_of_storage_ && relocatable::value) {
+        value_type x_copy = value;
+        open_gap(position, 1);
+        MYSTL_TRY {
+            #if MYSTL_CPP_VERSION >= 11
+            msl::construct(position, msl::move(x_copy));
+            #else
+            msl::construct(position, x_copy);
+            #endif
+        }
+        MYSTL_CATCH_ALL {
+            close_gap(position, 1);
+            MYSTL_RETHROW;
+        }
+    } else if (finish_ != end_of_storage_) {
+        value_type x_copy = value;  // value 可能是本容器中即将被移动的元素
         msl::construct(finish_, *(finish_ - 1));
         ++finish_;
         msl::copy_backward(position, finish_ - 2, finish_ - 1);
-        *position = value;
+        *position = x_copy;
     } else {
         realloc_insert(position, value);
     }
 }
 
 #if MYSTL_CPP_VERSION >= 11
-template<typename T,typename Alloc>
-void vector<T,Alloc>::insert_aux(iterator position, value_type&& value) {
-    if (finish_ != end_of_storage_) {
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::insert_aux(iterator position, value_type&& value) {
+    if (finish_ != end_of_storage_ && relocatable::value) {
+        open_gap(position, 1);
+        MYSTL_TRY {
+            msl::construct(position, msl::move(value));
+        }
+        MYSTL_CATCH_ALL {
+            close_gap(position, 1);
+            MYSTL_RETHROW;
+        }
+    } else if (finish_ != end_of_storage_) {
         msl::construct(finish_, msl::move(*(finish_ - 1)));
         ++finish_;
         msl::move_backward(position, finish_ - 2, finish_ - 1);
@@ -692,61 +971,53 @@ void vector<T,Alloc>::insert_aux(iterator position, value_type&& value) {
 }
 #endif
 
-template<typename T,typename Alloc>
-void vector<T,Alloc>::realloc_insert(iterator position, const_reference value) {
-    const size_type old_size = size();
-    const size_type new_capacity = old_size ? old_size * 2 : 1;
-    iterator new_start = data_allocator::allocate(new_capacity);
-    iterator new_finish = new_start;
-
-    const size_type elems_before = position - start_;
-    msl::construct(new_start + elems_before, value);
-
-    #if MYSTL_CPP_VERSION >= 11
-    new_finish = msl::uninitialized_move(start_, position, new_start);
-    #else
-    new_finish = msl::uninitialized_copy(start_, position, new_start);
-    #endif
-    
-    ++new_finish;
-
-    #if MYSTL_CPP_VERSION >= 11
-    new_finish = msl::uninitialized_move(position, finish_, new_finish);
-    #else
-    new_finish = msl::uninitialized_copy(position, finish_, new_finish);
-    #endif
-
-    msl::destroy(start_, finish_);
-    data_allocator::deallocate(start_, end_of_storage_ - start_);
-    start_ = new_start;
-    finish_ = new_finish;
-    end_of_storage_ = start_ + new_capacity;
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::realloc_insert(iterator position, const_reference value) {
+    const size_type new_capacity = recommend(size() + 1);
+    if (relocatable::value) {
+        value_type tmp(value);  // value 可能是本容器中的元素, 扩容后会失效
+        const size_type index = position - start_;
+        expand_storage(new_capacity, relocatable());
+        insert(start_ + index, tmp);
+        return;
+    }
+    iterator new_start = data_allocator::allocate(get_alloc(), new_capacity);
+    MYSTL_TRY {
+        msl::construct(new_start + (position - start_), value);
+    }
+    MYSTL_CATCH_ALL {
+        data_allocator::deallocate(get_alloc(), new_start, new_capacity);
+        MYSTL_RETHROW;
+    }
+    relocate_to(new_start, new_capacity, position, 1);
 }
 
 #if MYSTL_CPP_VERSION >= 11
-template<typename T,typename Alloc>
-void vector<T,Alloc>::realloc_insert(iterator position, value_type&& value) {
-    const size_type old_size = size();
-    const size_type new_capacity = old_size ? old_size * 2 : 1;
-    iterator new_start = data_allocator::allocate(new_capacity);
-    iterator new_finish = new_start;
-    
-    new_finish = msl::uninitialized_move(start_, position, new_start);
-    msl::construct(new_finish, msl::move(value));
-    ++new_finish;
-    new_finish = msl::uninitialized_move(position, finish_, new_finish);
-    
-    msl::destroy(start_, finish_);
-    data_allocator::deallocate(start_, end_of_storage_ - start_);
-    start_ = new_start;
-    finish_ = new_finish;
-    end_of_storage_ = start_ + new_capacity;
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::realloc_insert(iterator position, value_type&& value) {
+    const size_type new_capacity = recommend(size() + 1);
+    if (relocatable::value) {
+        value_type tmp(msl::move(value));
+        const size_type index = position - start_;
+        expand_storage(new_capacity, relocatable());
+        insert(start_ + index, msl::move(tmp));
+        return;
+    }
+    iterator new_start = data_allocator::allocate(get_alloc(), new_capacity);
+    MYSTL_TRY {
+        msl::construct(new_start + (position - start_), msl::move(value));
+    }
+    MYSTL_CATCH_ALL {
+        data_allocator::deallocate(get_alloc(), new_start, new_capacity);
+        MYSTL_RETHROW;
+    }
+    relocate_to(new_start, new_capacity, position, 1);
 }
 #endif
 
 
-template<typename T,typename Alloc>
-void vector<T,Alloc>::insert(iterator position,size_type n,const_reference value){
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::insert(iterator position,size_type n,const_reference value){
     if(n != 0){
         if(finish_ + n <= end_of_storage_){
             const size_type elems_after = finish_ - position;
@@ -782,32 +1053,23 @@ void vector<T,Alloc>::insert(iterator position,size_type n,const_reference value
             }
         }
         else {
-            const size_type old_size = size();
-            const size_type len = old_size + msl::max(old_size,n);
-            iterator new_start = data_allocator::allocate(len);
-            iterator new_finish = new_start;
+            const size_type len = recommend(size() + n);
+            iterator new_start = data_allocator::allocate(get_alloc(), len);
             MYSTL_TRY{
-                new_finish = msl::uninitialized_copy(start_, position, new_start);
-                new_finish = msl::uninitialized_fill_n(new_finish, n, value);
-                new_finish = msl::uninitialized_copy(position, finish_, new_finish);
+                msl::uninitialized_fill_n(new_start + (position - start_), n, value);
             }
             MYSTL_CATCH_ALL{
-                msl::destroy(new_start, new_finish);
-                data_allocator::deallocate(new_start, len);
+                data_allocator::deallocate(get_alloc(), new_start, len);
                 MYSTL_RETHROW;
             }
-            msl::destroy(start_,finish_);
-            deallocate();
-            start_ = new_start;
-            finish_ = new_finish;
-            end_of_storage_ = start_ + len;
+            relocate_to(new_start, len, position, n);
         }
     }
 }
 
-template<typename T,typename Alloc>
-typename vector<T,Alloc>::iterator
-vector<T,Alloc>::insert(iterator position,const_reference value){
+template<typename T,typename Alloc,typename Growth>
+typename vector<T,Alloc,Growth>::iterator
+vector<T,Alloc,Growth>::insert(iterator position,const_reference value){
     size_type n = position - begin();
     if (finish_ != end_of_storage_ && position == finish_) {
         msl::construct(finish_, value);
@@ -819,9 +1081,9 @@ vector<T,Alloc>::insert(iterator position,const_reference value){
 }
 
 #if MYSTL_CPP_VERSION >= 11
-template<typename T,typename Alloc>
-typename vector<T,Alloc>::iterator
-vector<T,Alloc>::insert(iterator position, value_type&& value){
+template<typename T,typename Alloc,typename Growth>
+typename vector<T,Alloc,Growth>::iterator
+vector<T,Alloc,Growth>::insert(iterator position, value_type&& value){
     size_type n = position - begin();
     if (finish_ != end_of_storage_ && position == finish_) {
         msl::construct(finish_, msl::move(value));
@@ -833,10 +1095,51 @@ vector<T,Alloc>::insert(iterator position, value_type&& value){
 }
 #endif
 
-template<typename T,typename Alloc>
-void vector<T,Alloc>::insert(iterator position,const_iterator first,const_iterator last){
-    size_type n = static_cast<size_type>(last - first);
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::insert(iterator position,const_iterator first,const_iterator last){
+    range_insert(position, first, last, msl::forward_iterator_tag());
+}
+
+template<typename T,typename Alloc,typename Growth>
+template<typename InputIt>
+void vector<T,Alloc,Growth>::range_insert(iterator position, InputIt first, InputIt last,
+                                          msl::input_iterator_tag) {
+    if (position == finish_) {
+        for (; first != last; ++first) push_back(*first);
+        return;
+    }
+    // 范围大小未知: 先追加到末尾, 再把追加的部分旋转到插入位置
+    const size_type index = position - start_;
+    const size_type old_size = size();
+    for (; first != last; ++first) push_back(*first);
+    reverse_range(start_ + index, start_ + old_size);
+    reverse_range(start_ + old_size, finish_);
+    reverse_range(start_ + index, finish_);
+}
+
+template<typename T,typename Alloc,typename Growth>
+template<typename ForwardIt>
+void vector<T,Alloc,Growth>::range_insert(iterator position, ForwardIt first, ForwardIt last,
+                                          msl::forward_iterator_tag) {
+    size_type n = static_cast<size_type>(msl::distance(first, last));
     if(n == 0) return;
+    if (relocatable::value) {
+        // 扩容交给 reallocate, 插入位置之后的元素整体 memmove, 然后在空位上构造
+        if (static_cast<size_type>(end_of_storage_ - finish_) < n) {
+            const size_type index = position - start_;
+            expand_storage(recommend(size() + n), relocatable());
+            position = start_ + index;
+        }
+        open_gap(position, n);
+        MYSTL_TRY {
+            msl::uninitialized_copy(first, last, position);
+        }
+        MYSTL_CATCH_ALL {
+            close_gap(position, n);
+            MYSTL_RETHROW;
+        }
+        return;
+    }
     if(static_cast<size_type>(end_of_storage_ - finish_) >= n){
         size_type elems_after = static_cast<size_type>(finish_ - position);
         iterator old_finish = finish_;
@@ -854,7 +1157,8 @@ void vector<T,Alloc>::insert(iterator position,const_iterator first,const_iterat
                 MYSTL_RETHROW;
             }
         } else {
-            const_iterator mid = first + elems_after;
+            ForwardIt mid = first;
+            msl::advance(mid, elems_after);
             iterator constructed = finish_;
             MYSTL_TRY {
                 msl::uninitialized_copy(mid, last, finish_);
@@ -870,54 +1174,45 @@ void vector<T,Alloc>::insert(iterator position,const_iterator first,const_iterat
             }
         }
     } else {
-        size_type old_size = size();
-        size_type new_len = old_size + msl::max(old_size, n);
-        iterator new_start = data_allocator::allocate(new_len);
-        iterator new_finish = new_start;
+        size_type new_len = recommend(size() + n);
+        iterator new_start = data_allocator::allocate(get_alloc(), new_len);
         MYSTL_TRY {
-            new_finish = msl::uninitialized_copy(start_, position, new_start);
-            new_finish = msl::uninitialized_copy(first, last, new_finish);
-            new_finish = msl::uninitialized_copy(position, finish_, new_finish);
+            msl::uninitialized_copy(first, last, new_start + (position - start_));
         }
         MYSTL_CATCH_ALL {
-            msl::destroy(new_start, new_finish);
-            data_allocator::deallocate(new_start, new_len);
+            data_allocator::deallocate(get_alloc(), new_start, new_len);
             MYSTL_RETHROW;
         }
-        msl::destroy(start_, finish_);
-        data_allocator::deallocate(start_, end_of_storage_ - start_);
-        start_ = new_start;
-        finish_ = new_finish;
-        end_of_storage_ = start_ + new_len;
+        relocate_to(new_start, new_len, position, n);
     }
 }
 
 
 
 #if MYSTL_CPP_VERSION >= 0
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIterator, typename V>
-void vector<T,Alloc>::assign(InputIterator first, InputIterator last) {
+void vector<T,Alloc,Growth>::assign(InputIterator first, InputIterator last) {
     typedef typename msl::is_integer<InputIterator>::Integral Integral;
     assign_dispatch(first, last, Integral());
 }
 
-template<typename T, typename Alloc>
-void vector<T,Alloc>::assign_dispatch(size_type n, const_reference value, msl::true_type) {
+template<typename T, typename Alloc, typename Growth>
+void vector<T,Alloc,Growth>::assign_dispatch(size_type n, const_reference value, msl::true_type) {
     fill_assign(n, value);
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt>
-void vector<T,Alloc>::assign_dispatch(InputIt first, InputIt last, msl::false_type) {
+void vector<T,Alloc,Growth>::assign_dispatch(InputIt first, InputIt last, msl::false_type) {
     typedef typename msl::iterator_traits<InputIt>::iterator_category Cat;
     static_assert(msl::is_msl_iterator_tag<Cat>::value, "must use msl iterator");
     assign_range(first, last, Cat());
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt>
-void vector<T,Alloc>::assign_range(InputIt first, InputIt last, msl::input_iterator_tag) {
+void vector<T,Alloc,Growth>::assign_range(InputIt first, InputIt last, msl::input_iterator_tag) {
     iterator cur = begin();
     iterator e = end();
     for (; cur != e && first != last; ++cur, ++first) {
@@ -932,15 +1227,15 @@ void vector<T,Alloc>::assign_range(InputIt first, InputIt last, msl::input_itera
     }
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename ForwardIt>
-void vector<T,Alloc>::assign_range(ForwardIt first, ForwardIt last, msl::forward_iterator_tag) {
+void vector<T,Alloc,Growth>::assign_range(ForwardIt first, ForwardIt last, msl::forward_iterator_tag) {
     size_type n = static_cast<size_type>(msl::distance(first, last));
     if (n > capacity()) {
-        iterator new_start = data_allocator::allocate(n);
+        iterator new_start = data_allocator::allocate(get_alloc(), n);
         iterator new_finish = msl::uninitialized_copy(first, last, new_start);
         msl::destroy(start_, finish_);
-        data_allocator::deallocate(start_, end_of_storage_ - start_);
+        data_allocator::deallocate(get_alloc(), start_, end_of_storage_ - start_);
         start_ = new_start;
         finish_ = new_finish;
         end_of_storage_ = start_ + n;
@@ -961,25 +1256,25 @@ void vector<T,Alloc>::assign_range(ForwardIt first, ForwardIt last, msl::forward
     }
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename RandomIt>
-void vector<T,Alloc>::assign_range(RandomIt first, RandomIt last, msl::random_access_iterator_tag) {
+void vector<T,Alloc,Growth>::assign_range(RandomIt first, RandomIt last, msl::random_access_iterator_tag) {
     assign_range(first, last, forward_iterator_tag());
 }
 
 #endif
 
 #if MYSTL_CPP_VERSION >= 11
-template<typename T,typename Alloc>
-void vector<T,Alloc>::insert(iterator position,std::initializer_list<T> ilist){
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::insert(iterator position,std::initializer_list<T> ilist){
     const_iterator first = ilist.begin();
     const_iterator last = ilist.end();
     insert(position, first, last);
 }
 #endif
 
-template<typename T,typename Alloc>
-void vector<T,Alloc>::fill_assign(size_type n, const_reference value){
+template<typename T,typename Alloc,typename Growth>
+void vector<T,Alloc,Growth>::fill_assign(size_type n, const_reference value){
     if(n > capacity()){
         reserve(n);
     }
@@ -990,72 +1285,84 @@ void vector<T,Alloc>::fill_assign(size_type n, const_reference value){
     finish_ = start_ + n;
 }
 
-template <typename T, typename Alloc>
-inline bool operator==(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+// 元素是算术类型时, equal 在原生指针上使用 SIMD 内核
+template <typename T, typename Alloc, typename Growth>
+inline bool operator==(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
     return x.size() == y.size() && msl::equal(x.begin(), x.end(), y.begin());
 }
 
-template <typename T, typename Alloc>
-inline bool operator!=(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Growth>
+inline bool operator!=(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
     return !(x == y);
 }
 
-template <typename T, typename Alloc>
-inline bool operator<(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Growth>
+inline bool operator<(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
     return msl::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
 }
 
-template <typename T, typename Alloc>
-inline bool operator>(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Growth>
+inline bool operator>(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
     return y < x;
 }
 
-template <typename T, typename Alloc>
-inline bool operator<=(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Growth>
+inline bool operator<=(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
     return !(y < x);
 }
 
-template <typename T, typename Alloc>
-inline bool operator>=(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Growth>
+inline bool operator>=(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
     return !(x < y);
 }
 
-template <typename T, typename Alloc>
-inline void swap(vector<T, Alloc>& x, vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Growth>
+inline void swap(vector<T, Alloc, Growth>& x, vector<T, Alloc, Growth>& y) {
     x.swap(y);
 }
 
-template<typename T, typename Alloc>
-void vector<T,Alloc>::shrink_to_fit() {
+template<typename T, typename Alloc, typename Growth>
+void vector<T,Alloc,Growth>::shrink_to_fit() {
     if (finish_ == start_) {
         if (start_) {
-            data_allocator::deallocate(start_, end_of_storage_ - start_);
+            data_allocator::deallocate(get_alloc(), start_, end_of_storage_ - start_);
             start_ = 0;
             finish_ = 0;
             end_of_storage_ = 0;
         }
         return;
     }
-    if (end_of_storage_ != finish_) {
+    if (end_of_storage_ != finish_ && relocatable::value) {
+        const size_type n = size();
+        start_ = data_allocator::reallocate(get_alloc(), start_, capacity(), n);
+        finish_ = start_ + n;
+        end_of_storage_ = finish_;
+    } else if (end_of_storage_ != finish_) {
         size_type new_capacity = size();
-        iterator new_start = data_allocator::allocate(new_capacity);
-        iterator new_finish = msl::uninitialized_copy(start_, finish_, new_start);
-        msl::destroy(start_, finish_);
-        data_allocator::deallocate(start_, end_of_storage_ - start_);
-        start_ = new_start;
-        finish_ = new_finish;
-        end_of_storage_ = start_ + new_capacity;
+        iterator new_start = data_allocator::allocate(get_alloc(), new_capacity);
+        relocate_to(new_start, new_capacity, finish_, 0);
     }
 }
 
 
 
 #if MYSTL_CPP_VERSION >= 11
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename... Args>
-typename vector<T, Alloc>::iterator
-vector<T,Alloc>::emplace(iterator position, Args&&... args) {
-    if (finish_ != end_of_storage_) {
+typename vector<T, Alloc, Growth>::iterator
+vector<T,Alloc,Growth>::emplace(iterator position, Args&&... args) {
+    if (finish_ != end_of_storage_ && relocatable::value) {
+        value_type tmp(msl::forward<Args>(args)...);  // args 可能引用本容器中的元素
+        open_gap(position, 1);
+        MYSTL_TRY {
+            msl::construct(position, msl::move(tmp));
+        }
+        MYSTL_CATCH_ALL {
+            close_gap(position, 1);
+            MYSTL_RETHROW;
+        }
+        return position;
+    } else if (finish_ != end_of_storage_) {
         msl::construct(finish_, *(finish_ - 1));
         ++finish_;
         msl::copy_backward(position, finish_ - 2, finish_ - 1);
@@ -1067,9 +1374,9 @@ vector<T,Alloc>::emplace(iterator position, Args&&... args) {
     }
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename... Args>
-void vector<T,Alloc>::emplace_back(Args&&... args) {
+void vector<T,Alloc,Growth>::emplace_back(Args&&... args) {
     if (finish_ != end_of_storage_) {
         new (finish_) T(msl::forward<Args>(args)...);
         ++finish_;
@@ -1078,24 +1385,26 @@ void vector<T,Alloc>::emplace_back(Args&&... args) {
     }
 }
 
-template<typename T,typename Alloc>
+template<typename T,typename Alloc,typename Growth>
 template<typename... Args>
-typename vector<T,Alloc>::iterator
-vector<T,Alloc>::realloc_emplace(iterator position, Args&&... args) {
-    size_type old_size = size();
-    size_type new_capacity = old_size ? old_size * 2 : 1;
-    iterator new_start = data_allocator::allocate(new_capacity);
-    iterator new_finish = new_start;
+typename vector<T,Alloc,Growth>::iterator
+vector<T,Alloc,Growth>::realloc_emplace(iterator position, Args&&... args) {
+    size_type new_capacity = recommend(size() + 1);
     size_type pos_index = static_cast<size_type>(position - start_);
-    new_finish = msl::uninitialized_move(start_, position, new_start);
-    new (new_finish) T(msl::forward<Args>(args)...);
-    ++new_finish;
-    new_finish = msl::uninitialized_move(position, finish_, new_finish);
-    msl::destroy(start_, finish_);
-    data_allocator::deallocate(start_, end_of_storage_ - start_);
-    start_ = new_start;
-    finish_ = new_finish;
-    end_of_storage_ = start_ + new_capacity;
+    if (relocatable::value) {
+        value_type tmp(msl::forward<Args>(args)...);
+        expand_storage(new_capacity, relocatable());
+        return insert(start_ + pos_index, msl::move(tmp));
+    }
+    iterator new_start = data_allocator::allocate(get_alloc(), new_capacity);
+    MYSTL_TRY {
+        new (static_cast<void*>(new_start + pos_index)) T(msl::forward<Args>(args)...);
+    }
+    MYSTL_CATCH_ALL {
+        data_allocator::deallocate(get_alloc(), new_start, new_capacity);
+        MYSTL_RETHROW;
+    }
+    relocate_to(new_start, new_capacity, position, 1);
     return start_ + pos_index;
 }
 
@@ -1107,4 +1416,6 @@ vector<T,Alloc>::realloc_emplace(iterator position, Args&&... args) {
 
 } // namespace msl
 
+#include "stl_bvector.h"
+
 #endif // MYSTL_VECTOR_H
\ No newline at end of file
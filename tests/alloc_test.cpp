@@ -0,0 +1,492 @@
+// 打开配置器的统计计数, 供 test_alloc_stats 检查
+#define MYSTL_ALLOC_STATS
+#include "memory.h"
+#include "list.h"
+#include "map.h"
+#include "deque.h"
+#include "vector.h"
+#include "hash_map.h"
+#include "set.h"
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstring>
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+// 1. 单线程配置器的基本分配/回收
+void test_single_client_alloc() {
+    std::cout << "\n[Running test_single_client_alloc]" << std::endl;
+    typedef msl::single_client_alloc A;
+    void* p1 = A::allocate(24);
+    void* p2 = A::allocate(24);
+    assert(p1 && p2 && p1 != p2);
+    A::deallocate(p1, 24);
+    void* p3 = A::allocate(24);
+    assert(p3 == p1); // 刚归还的区块会被立刻复用
+    A::deallocate(p2, 24);
+    A::deallocate(p3, 24);
+
+    void* big = A::allocate(1000); // 大于 MAX_BYTES, 交给一级配置器
+    assert(big);
+    A::deallocate(big, 1000);
+    std::cout << "single_client_alloc passed." << std::endl;
+}
+
+// 2. 多线程同时使用 thread_alloc 的节点容器
+void worker(int id, long* sum) {
+    msl::list<int, msl::thread_alloc> l;
+    msl::map<int, int, msl::less<int>, msl::thread_alloc> m;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 500; ++i) {
+            l.push_back(i + id);
+            m.insert(msl::make_pair(i, i + id));
+        }
+        while (!l.empty()) l.pop_front();
+        m.clear();
+    }
+    for (int i = 0; i < 100; ++i) l.push_back(i);
+    long s = 0;
+    for (msl::list<int, msl::thread_alloc>::iterator it = l.begin(); it != l.end(); ++it) s += *it;
+    *sum = s;
+}
+
+void test_thread_alloc() {
+    std::cout << "\n[Running test_thread_alloc]" << std::endl;
+    const int n = 4;
+    std::vector<std::thread> threads;
+    long sums[n];
+    for (int i = 0; i < n; ++i) threads.push_back(std::thread(worker, i, &sums[i]));
+    for (int i = 0; i < n; ++i) threads[i].join();
+    for (int i = 0; i < n; ++i) assert(sums[i] == 4950);
+
+    // 工作线程退出后, 缓存的区块已归还中心内存池, 主线程可以继续使用
+    msl::list<int, msl::thread_alloc> l;
+    for (int i = 0; i < 1000; ++i) l.push_back(i);
+    assert(l.size() == 1000);
+    std::cout << "thread_alloc passed." << std::endl;
+}
+
+// 静态对象在主线程的线程缓存析构之后才析构, 这时释放的区块直接回到中心链表
+typedef msl::default_alloc_template<true, 7> exit_alloc;
+
+struct exit_release {
+    void* block;
+    size_t free_before;
+    ~exit_release() {
+        if (!block) return;
+        exit_alloc::deallocate(block, 8);
+        // 线程缓存已经全部还给中心链表, 不能再被计入或者写入
+        assert(exit_alloc::stats().classes[0].free_blocks == free_before + 1);
+    }
+};
+static exit_release g_exit_release;
+
+void test_release_after_thread_exit() {
+    std::cout << "\n[Running test_release_after_thread_exit]" << std::endl;
+    g_exit_release.block = exit_alloc::allocate(8);
+    g_exit_release.free_before = exit_alloc::stats().classes[0].free_blocks;
+    assert(g_exit_release.free_before > 0);
+    std::cout << "release after thread exit scheduled." << std::endl;
+}
+
+// 3. trim: 峰值过后把完全空闲的chunk还给系统
+void test_trim() {
+    std::cout << "\n[Running test_trim]" << std::endl;
+    typedef msl::default_alloc_template<false, 1> A; // 独立的内存池, 不受其他测试影响
+    const int n = 100000;
+    std::vector<void*> blocks(n);
+    for (int i = 0; i < n; ++i) blocks[i] = A::allocate(32);
+    size_t peak = A::pool_size();
+    assert(peak >= (size_t)n * 32);
+    std::cout << "pool size at peak: " << peak << std::endl;
+
+    // 还有区块在使用时, 只有完全空闲的chunk会被释放
+    for (int i = 0; i < n - 1; ++i) A::deallocate(blocks[i], 32);
+    size_t released = A::trim();
+    assert(released > 0);
+    assert(A::pool_size() == peak - released);
+    assert(A::pool_size() > 0);
+
+    A::deallocate(blocks[n - 1], 32);
+    A::trim();
+    assert(A::pool_size() == 0);
+    std::cout << "pool size after trim: " << A::pool_size() << std::endl;
+
+    // trim 之后内存池仍可正常使用
+    void* p = A::allocate(64);
+    assert(p);
+    A::deallocate(p, 64);
+    std::cout << "trim passed." << std::endl;
+}
+
+// 4. 高水位线: 超过阈值后在回收路径上自动trim
+void test_trim_threshold() {
+    std::cout << "\n[Running test_trim_threshold]" << std::endl;
+    typedef msl::default_alloc_template<false, 2> A;
+    A::set_trim_threshold(64 * 1024);
+    {
+        msl::map<int, int, msl::less<int>, A> m;
+        for (int i = 0; i < 100000; ++i) m.insert(msl::make_pair(i, i));
+        assert(A::pool_size() > 64 * 1024);
+    }
+    std::cout << "pool size after spike: " << A::pool_size() << std::endl;
+    assert(A::pool_size() <= 64 * 1024);
+    A::set_trim_threshold(0);
+    std::cout << "trim threshold passed." << std::endl;
+}
+
+// 5. pool_alloc: 几何分级和自定义对齐
+void test_pool_alloc() {
+    std::cout << "\n[Running test_pool_alloc]" << std::endl;
+    typedef msl::pool_alloc_template<16, 4096, 0> P;
+    assert(P::good_size(1) == 16);
+    assert(P::good_size(128) == 128);
+    assert(P::good_size(129) == 160);
+    assert(P::good_size(300) == 320);
+    assert(P::good_size(512) == 512);
+    assert(P::good_size(513) == 640);
+    assert(P::good_size(4096) == 4096);
+    assert(P::good_size(5000) == 5000);
+
+    typedef msl::pool_alloc_template<64, 8192, 0> P64;
+    std::vector<void*> blocks;
+    std::vector<size_t> sizes;
+    for (size_t n = 1; n <= 10000; n = n * 3 / 2 + 1) {
+        void* p = P64::allocate(n);
+        assert(((size_t)p & 63) == 0);
+        memset(p, 0xab, n);
+        blocks.push_back(p);
+        sizes.push_back(n);
+    }
+    for (size_t i = 0; i < blocks.size(); ++i) P64::deallocate(blocks[i], sizes[i]);
+
+    // 512 字节的 deque 缓冲区和较大的 map 节点都从内存池分配
+    msl::deque<int, msl::pool_alloc> d;
+    for (int i = 0; i < 10000; ++i) d.push_back(i);
+    assert(d.size() == 10000 && d[9999] == 9999);
+    msl::map<int, std::string, msl::less<int>, msl::pool_alloc> m;
+    for (int i = 0; i < 1000; ++i) m.insert(msl::make_pair(i, std::string(100, 'x')));
+    assert(m.size() == 1000 && m[500].size() == 100);
+    std::cout << "pool_alloc passed." << std::endl;
+}
+
+// 6. 单调 arena: 容器持有 arena_alloc 实例, 所有节点都从同一个 arena 分配
+void test_arena() {
+    std::cout << "\n[Running test_arena]" << std::endl;
+    typedef msl::arena_alloc A;
+    {
+        msl::arena ar(1024);
+        A a(ar);
+        msl::vector<int, A> v(a);
+        for (int i = 0; i < 1000; ++i) v.push_back(i);
+        assert(v.size() == 1000 && v[999] == 999);
+        assert(v.get_allocator() == a);
+
+        msl::map<int, int, msl::less<int>, A> m(msl::less<int>(), a);
+        for (int i = 0; i < 500; ++i) m[i] = i * 2;
+        assert(m.size() == 500 && m[250] == 500);
+
+        msl::hash_map<int, int, msl::hash<int>, msl::equal_to<int>, A> hm(
+            100, msl::hash<int>(), msl::equal_to<int>(), a);
+        for (int i = 0; i < 500; ++i) hm.insert(msl::make_pair(i, i));
+        assert(hm.size() == 500 && hm.find(123)->second == 123);
+
+        msl::list<int, A> l(a);
+        for (int i = 0; i < 200; ++i) l.push_back(200 - i);
+        l.sort();
+        assert(l.front() == 1 && l.back() == 200);
+        assert(l.get_allocator() == a);
+
+        msl::vector<int, A> copy(v);  // 拷贝沿用源容器的 arena
+        assert(copy.get_allocator() == a);
+        assert(ar.bytes_allocated() > 0);
+    } // 容器先于 arena 析构, 所有内存随 arena 一并释放
+
+    // 外部缓冲区: 放得下的请求不需要调用 malloc
+    char buf[4096];
+    msl::arena ar(buf, sizeof(buf));
+    void* p = ar.allocate(100);
+    assert(p >= (void*)buf && p < (void*)(buf + sizeof(buf)));
+    void* q = ar.reallocate(p, 100, 200);  // 最近一次分配可以原地扩展
+    assert(q == p);
+    ar.release();
+    assert(ar.bytes_allocated() == 0);
+
+    // 默认构造的 arena_alloc 退化为 malloc
+    msl::vector<int, A> plain;
+    plain.push_back(1);
+    assert(plain.get_allocator().resource() == 0);
+    std::cout << "arena passed." << std::endl;
+}
+
+// 7. 统计计数器与直方图输出
+void test_alloc_stats() {
+    std::cout << "\n[Running test_alloc_stats]" << std::endl;
+    typedef msl::default_alloc_template<false, 3> A;
+    msl::default_alloc_stats s0 = A::stats();
+    assert(s0.heap_size == 0 && s0.chunks == 0 && s0.classes[0].allocs == 0);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 30; ++i) blocks.push_back(A::allocate(13)); // 16 字节级别, 每个浪费 3 字节
+    void* big = A::allocate(1000);
+
+    msl::default_alloc_stats s = A::stats();
+    assert(s.classes[1].size == 16);
+    assert(s.classes[1].allocs == 30 && s.classes[1].deallocs == 0);
+    assert(s.large_allocs == 1);
+    assert(s.round_up_waste == 30 * 3);
+    assert(s.refills == 2);            // 每次 refill 取 20 个区块
+    assert(s.chunk_allocs == 2);
+    assert(s.system_allocs == 1);
+    assert(s.chunks == 1 && s.heap_size > 0);
+    assert(s.classes[1].free_blocks == 10);
+
+    for (size_t i = 0; i < blocks.size(); ++i) A::deallocate(blocks[i], 13);
+    A::deallocate(big, 1000);
+    s = A::stats();
+    assert(s.classes[1].deallocs == 30 && s.large_deallocs == 1);
+    assert(s.round_up_waste == 0);
+    assert(s.classes[1].free_blocks == 40);
+
+    msl::malloc_alloc_stats ms = msl::malloc_alloc::stats();
+    assert(ms.allocs >= 1 && ms.deallocs >= 1);
+
+    A::dump_stats(stdout);
+    A::reset_stats();
+    s = A::stats();
+    assert(s.classes[1].allocs == 0 && s.refills == 0);
+    assert(s.classes[1].free_blocks == 40); // 现场统计的字段不受 reset 影响
+    std::cout << "alloc_stats passed." << std::endl;
+}
+
+// 8. 可替换的chunk来源: mmap 与 2MB 对齐的透明大页
+void test_chunk_source() {
+    std::cout << "\n[Running test_chunk_source]" << std::endl;
+    typedef msl::default_alloc_template<false, 4> A;
+    msl::chunk_source old = A::set_chunk_source(msl::huge_page_chunk_source());
+    assert(old.allocate == &msl::__malloc_chunk_allocate);
+
+    void* first = A::allocate(32);
+#ifdef MYSTL_PLATFORM_LINUX
+    // 第一个区块紧跟在chunk头部之后, chunk本身按 2MB 对齐
+    assert((size_t)first % msl::HUGE_PAGE_SIZE < 64);
+    assert(A::pool_size() >= (size_t)msl::HUGE_PAGE_SIZE - 64);
+#endif
+    A::deallocate(first, 32);
+    {
+        msl::map<int, int, msl::less<int>, A> m;
+        for (int i = 0; i < 100000; ++i) m[i] = i;
+        assert(m.size() == 100000 && m[99999] == 99999);
+    }
+    A::trim();
+    assert(A::pool_size() == 0);
+
+    // 切换来源后, 新旧chunk各自用申请时的来源释放
+    A::set_chunk_source(msl::mmap_chunk_source());
+    void* p = A::allocate(64);
+    A::set_chunk_source(msl::malloc_chunk_source());
+    {
+        msl::list<int, A> l;
+        for (int i = 0; i < 10000; ++i) l.push_back(i);
+    }
+    A::deallocate(p, 64);
+    A::trim();
+    assert(A::pool_size() == 0);
+    std::cout << "chunk_source passed." << std::endl;
+}
+
+// 9. 批量申请/归还区块, 以及节点容器的区间插入和 clear
+void test_batch() {
+    std::cout << "\n[Running test_batch]" << std::endl;
+    typedef msl::default_alloc_template<false, 5> A;
+    void* blocks[50];
+    A::allocate_batch(24, blocks, 50);
+    for (int i = 0; i < 50; ++i) {
+        assert(blocks[i]);
+        memset(blocks[i], i, 24);
+        for (int j = 0; j < i; ++j) assert(blocks[i] != blocks[j]);
+    }
+    msl::default_alloc_stats s = A::stats();
+    assert(s.classes[2].allocs == 50 && s.refills == 0);
+    A::deallocate_batch(24, blocks, 50);
+    s = A::stats();
+    assert(s.classes[2].deallocs == 50 && s.classes[2].free_blocks >= 50);
+    // 归还的区块全部在空闲链表上, 再取一批不需要新的 chunk
+    size_t chunks = s.chunks;
+    A::allocate_batch(24, blocks, 50);
+    assert(A::stats().chunks == chunks);
+    A::deallocate_batch(24, blocks, 50);
+
+    void* big[3];
+    A::allocate_batch(1000, big, 3);
+    A::deallocate_batch(1000, big, 3);
+
+    // 线程缓存版本
+    typedef msl::default_alloc_template<true, 5> T;
+    void* tb[100];
+    T::allocate_batch(16, tb, 100);
+    T::deallocate_batch(16, tb, 30);
+    T::deallocate_batch(16, tb + 30, 70);
+    T::trim();
+    assert(T::pool_size() == 0);
+
+    // 容器的区间构造/插入与 clear
+    std::vector<int> src;
+    for (int i = 0; i < 1000; ++i) src.push_back(i % 700);
+    msl::set<int, msl::less<int>, A> st(src.data(), src.data() + src.size());
+    assert(st.size() == 700 && *st.begin() == 0);
+    msl::list<int, A> l(src.begin(), src.end());
+    assert(l.size() == 1000 && l.back() == 299);
+    l.insert(l.begin(), (size_t)5, 7);
+    assert(l.front() == 7 && l.size() == 1005);
+    msl::hash_map<int, int, msl::hash<int>, msl::equal_to<int>, A> hm;
+    std::vector<msl::pair<const int, int> > kv;
+    for (int i = 0; i < 500; ++i) kv.push_back(msl::pair<const int, int>(i % 300, i));
+    hm.insert(kv.data(), kv.data() + kv.size());
+    assert(hm.size() == 300 && hm.find(299) != hm.end());
+    st.clear();
+    l.clear();
+    hm.clear();
+    assert(st.empty() && l.empty() && hm.empty());
+
+    // 借助 arena 检查 list 的区间插入得到的节点地址递增
+    msl::arena ar;
+    msl::list<int, msl::arena_alloc> al(src.begin(), src.begin() + 40, msl::arena_alloc(ar));
+    const int* prev = 0;
+    for (msl::list<int, msl::arena_alloc>::iterator it = al.begin(); it != al.end(); ++it) {
+        assert(prev == 0 || &*it > prev);
+        prev = &*it;
+    }
+    std::cout << "batch passed." << std::endl;
+}
+
+// 10. 调试配置器: 越界写, 重复释放, 大小不匹配, 释放后写入
+static std::string g_debug_error;
+void record_debug_error(const char* msg, void*, size_t) { g_debug_error = msg; }
+
+void test_debug_alloc() {
+    std::cout << "\n[Running test_debug_alloc]" << std::endl;
+    typedef msl::debug_alloc<msl::malloc_alloc> D;
+    D::set_error_handler(&record_debug_error);
+
+    char* p = (char*)D::allocate(10);
+    assert(((size_t)p & 15) == 0);
+    assert((unsigned char)p[0] == 0xcd);        // 新区块有填充
+    D::deallocate(p, 12);
+    assert(g_debug_error.find("size") != std::string::npos);
+    g_debug_error.clear();
+    D::deallocate(p, 10);
+    assert(g_debug_error.empty());
+    D::deallocate(p, 10);                       // 还在隔离区中
+    assert(g_debug_error.find("double free") != std::string::npos);
+    g_debug_error.clear();
+
+    char* q = (char*)D::allocate(8);
+    char saved = q[8];
+    q[8] = 'x';                                 // 越界一个字节
+    D::deallocate(q, 8);
+    assert(g_debug_error.find("past end") != std::string::npos);
+    g_debug_error.clear();
+    q[8] = saved;                               // 出错的区块没有被释放, 修好后再释放
+    D::deallocate(q, 8);
+    assert(g_debug_error.empty());
+
+    char* r = (char*)D::allocate(32);
+    D::deallocate(r, 32);
+    r[3] = 1;                                   // 释放后写入, 离开隔离区时发现
+    D::flush_quarantine();
+    assert(g_debug_error.find("after free") != std::string::npos);
+    g_debug_error.clear();
+
+    // 通过 Alloc 参数接入各种容器
+    typedef msl::debug_alloc<msl::default_alloc_template<false, 6> > DA;
+    DA::set_error_handler(&record_debug_error);
+    {
+        msl::vector<std::string, DA> v;
+        for (int i = 0; i < 200; ++i) v.push_back(std::string(i % 20, 'a'));
+        msl::vector<int, DA> vi;
+        for (int i = 0; i < 1000; ++i) vi.push_back(i);
+        msl::list<int, DA> l(vi.begin(), vi.end());
+        l.sort();
+        msl::map<int, std::string, msl::less<int>, DA> m;
+        for (int i = 0; i < 300; ++i) m[i] = "x";
+        msl::deque<int, DA> d;
+        for (int i = 0; i < 3000; ++i) d.push_front(i);
+        msl::hash_map<int, int, msl::hash<int>, msl::equal_to<int>, DA> hm;
+        for (int i = 0; i < 300; ++i) hm.insert(msl::make_pair(i, i));
+        m.clear();
+        hm.clear();
+    }
+    DA::flush_quarantine();
+    assert(g_debug_error.empty());
+
+    // 用户数据的对齐与底层配置器一致
+    typedef msl::debug_alloc<msl::aligned_alloc<16> > D16;
+    for (size_t n = 1; n <= 64; ++n) {
+        void* p = D16::allocate(n);
+        assert(((size_t)p & 15) == 0);
+        D16::deallocate(p, n);
+    }
+    D16::flush_quarantine();
+    std::cout << "debug_alloc passed." << std::endl;
+}
+
+// 11. 对齐配置器: 缓存行对齐, 以及尊重 alignof(T)
+struct alignas(64) padded_counter {
+    long value;
+};
+
+void test_aligned_alloc() {
+    std::cout << "\n[Running test_aligned_alloc]" << std::endl;
+    msl::vector<float, msl::aligned_alloc<32> > v;
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back((float)i);
+        assert(((size_t)v.data() & 31) == 0);
+    }
+    assert(v[999] == 999.0f);
+
+    // aligned_alloc<> 只保证类型本身的对齐
+    msl::vector<padded_counter, msl::aligned_alloc<> > counters(8);
+    assert(((size_t)counters.data() & 63) == 0);
+    assert(((size_t)&counters[3] & 63) == 0);
+
+    msl::list<int, msl::aligned_alloc<64> > l;
+    for (int i = 0; i < 100; ++i) l.push_back(i);
+    for (msl::list<int, msl::aligned_alloc<64> >::iterator it = l.begin(); it != l.end(); ++it)
+        assert(((size_t)&*it & 63) == 2 * sizeof(void*));   // 节点按 64 对齐, 数据在两个指针之后
+
+    msl::map<int, int, msl::less<int>, msl::aligned_alloc<64> > m;
+    for (int i = 0; i < 100; ++i) m[i] = i;
+    assert(m.size() == 100);
+
+    void* p = msl::aligned_alloc<128>::allocate(100);
+    assert(((size_t)p & 127) == 0);
+    msl::aligned_alloc<128>::deallocate(p, 100);
+    std::cout << "aligned_alloc passed." << std::endl;
+}
+
+int main() {
+    print();
+    std::cout << "Starting Alloc Tests..." << std::endl;
+
+    test_single_client_alloc();
+    test_thread_alloc();
+    test_release_after_thread_exit();
+    test_trim();
+    test_trim_threshold();
+    test_pool_alloc();
+    test_arena();
+    test_alloc_stats();
+    test_chunk_source();
+    test_batch();
+    test_debug_alloc();
+    test_aligned_alloc();
+
+    std::cout << "\nAll tests passed successfully!" << std::endl;
+    return 0;
+}
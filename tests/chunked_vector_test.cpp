@@ -0,0 +1,86 @@
+#include "chunked_vector.h"
+#include "algorithm.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+struct summer {
+    long sum;
+    summer() : sum(0) {}
+    void operator()(int x) { sum += x; }
+};
+
+void test_growth() {
+    std::cout << "\n[Running test_growth]" << std::endl;
+    msl::chunked_vector<int, 16> v;
+    assert(v.empty() && v.capacity() == 0 && v.CHUNK_SIZE == 16);
+    v.push_back(0);
+    const int* first = &v[0];
+    for (int i = 1; i < 1000; ++i) v.push_back(i);
+    assert(&v[0] == first);             // growth never moves elements
+    assert(v.size() == 1000 && v.capacity() == 1008);
+    for (int i = 0; i < 1000; ++i) assert(v[i] == i && v.at(i) == i);
+    assert(v.front() == 0 && v.back() == 999);
+    assert(v.end() - v.begin() == 1000 && *(v.begin() + 17) == 17 && v.rbegin()[1] == 998);
+
+    v.resize(20);
+    v.shrink_to_fit();
+    assert(v.size() == 20 && v.capacity() == 32 && &v[0] == first);
+    v.clear();
+    assert(v.empty() && v.capacity() == 32);
+
+    // Default chunk is about a page
+    assert((msl::chunked_vector<int>::CHUNK_SIZE == 1024));
+    assert((msl::chunked_vector<char[5000]>::CHUNK_SIZE == 1));
+}
+
+void test_segment_algorithms() {
+    std::cout << "\n[Running test_segment_algorithms]" << std::endl;
+    msl::chunked_vector<int, 64> v;
+    for (int i = 0; i < 1000; ++i) v.emplace_back(i);
+    summer s = msl::for_each(v.begin() + 10, v.end() - 5, summer());
+    assert(s.sum == 994L * 995 / 2 - 45);
+
+    msl::vector<int> out(1000, -1);
+    int* e = msl::copy(v.begin() + 1, v.end(), out.begin() + 1);
+    assert(e == out.end() && out[0] == -1 && out[1] == 1 && out[999] == 999);
+
+    long seg_sum = 0;
+    size_t segments = 0;
+    v.for_each_segment([&](const int* f, const int* l) { ++segments; for (; f != l; ++f) seg_sum += *f; });
+    assert(segments == 16 && seg_sum == 999L * 1000 / 2);
+}
+
+void test_copy_move() {
+    std::cout << "\n[Running test_copy_move]" << std::endl;
+    msl::chunked_vector<std::string, 4> a(10, "x");
+    a.push_back("last");
+    msl::chunked_vector<std::string, 4> b(a);
+    assert(b.size() == 11 && b[10] == "last" && b[3] == "x");
+    msl::chunked_vector<std::string, 4> c(msl::move(b));
+    assert(c.size() == 11 && b.empty());
+    b = c;
+    c = msl::move(a);
+    assert(b == c && !(b != c));
+    msl::swap(a, b);
+    assert(a.size() == 11 && b.empty());
+    msl::vector<std::string> src(5, "y");
+    msl::chunked_vector<std::string, 4> d(src.begin(), src.end());
+    assert(d.size() == 5 && d[4] == "y");
+}
+
+int main() {
+    print();
+    std::cout << "Starting chunked_vector Tests..." << std::endl;
+
+    test_growth();
+    test_segment_algorithms();
+    test_copy_move();
+
+    std::cout << "\nAll tests passed successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <stdexcept>
+#include "flat_hash_map.h"
+#include "hash_map.h"
+
+using namespace msl;
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+void test_basic() {
+    std::cout << "\n[Running test_basic]" << std::endl;
+    flat_hash_map<int, int> hm;
+    assert(hm.empty() && hm.size() == 0);
+
+    assert(hm.insert(msl::make_pair(1, 10)).second);
+    assert(hm.insert(msl::make_pair(2, 20)).second);
+    assert(!hm.insert(msl::make_pair(1, 99)).second);
+    hm[3] = 30;
+    assert(hm.size() == 3 && hm[1] == 10 && hm[3] == 30);
+    assert(hm.count(2) == 1 && hm.count(4) == 0);
+
+    flat_hash_map<int, int>::iterator it = hm.find(2);
+    assert(it != hm.end() && it->second == 20);
+    it->second = 21;
+    assert(hm[2] == 21 && hm.find(4) == hm.end());
+
+    int sum = 0;
+    for (it = hm.begin(); it != hm.end(); ++it) sum += it->first;
+    assert(sum == 6);
+
+    assert(hm.erase(1) == 1 && hm.erase(1) == 0);
+    hm.erase(hm.find(2));
+    assert(hm.size() == 1 && hm.begin()->first == 3);
+    hm.clear();
+    assert(hm.empty() && hm.begin() == hm.end());
+
+    msl::pair<int, int> arr[] = { msl::make_pair(1, 1), msl::make_pair(2, 4), msl::make_pair(3, 9) };
+    flat_hash_map<int, int> hm3(arr, arr + 3);
+    assert(hm3.size() == 3 && hm3[2] == 4);
+    flat_hash_map<int, int> hm4;
+    hm4.swap(hm3);
+    assert(hm4.size() == 3 && hm3.empty());
+}
+
+// 与链式 hash_map 对照: 大量插入, 查找和删除, 键有明显的低位规律
+void test_against_hash_map() {
+    std::cout << "\n[Running test_against_hash_map]" << std::endl;
+    flat_hash_map<long, std::string> flat(8);
+    hash_map<long, std::string> chained;
+    unsigned seed = 7;
+    for (int round = 0; round < 20000; ++round) {
+        seed = seed * 1103515245u + 12345u;
+        long k = static_cast<long>((seed >> 8) % 3000) * 1024;
+        int op = (seed >> 4) % 3;
+        if (op < 2) {
+            std::string v(1 + k % 17, char('a' + k % 26));
+            bool a = flat.insert(msl::make_pair(k, v)).second;
+            bool b = chained.insert(msl::make_pair(k, v)).second;
+            assert(a == b);
+        } else {
+            assert(flat.erase(k) == chained.erase(k));
+        }
+        assert(flat.size() == chained.size());
+    }
+    for (hash_map<long, std::string>::iterator it = chained.begin(); it != chained.end(); ++it) {
+        flat_hash_map<long, std::string>::const_iterator pos = flat.find(it->first);
+        assert(pos != flat.end() && pos->second == it->second);
+    }
+    size_t n = 0;
+    for (flat_hash_map<long, std::string>::iterator it = flat.begin(); it != flat.end(); ++it, ++n)
+        assert(chained.count(it->first) == 1);
+    assert(n == flat.size());
+}
+
+void test_erase_while_iterating() {
+    std::cout << "\n[Running test_erase_while_iterating]" << std::endl;
+    flat_hash_map<int, int> hm;
+    for (int i = 0; i < 1000; ++i) hm[i] = i;
+    // erase 返回下一个元素, 被前移的元素不会漏掉
+    for (flat_hash_map<int, int>::iterator it = hm.begin(); it != hm.end(); ) {
+        if (it->first % 3 == 0) it = hm.erase(it);
+        else ++it;
+    }
+    assert(hm.size() == 666);
+    for (int i = 0; i < 1000; ++i) assert(hm.count(i) == (i % 3 != 0 ? 1u : 0u));
+
+    hm.erase(hm.begin(), hm.end());
+    assert(hm.empty());
+}
+
+void test_copy_and_equal() {
+    std::cout << "\n[Running test_copy_and_equal]" << std::endl;
+    flat_hash_map<std::string, int> a;
+    for (int i = 0; i < 200; ++i) a[std::string(i % 7 + 1, 'x') + char('0' + i % 10) + std::to_string(i)] = i;
+    flat_hash_map<std::string, int> b(a);
+    assert(a == b && b.size() == 200);
+    b["x0"] = 1;
+    assert(a != b);
+    b = a;
+    assert(a == b);
+    b.begin()->second = -1;
+    assert(a != b);
+}
+
+struct same_hash {
+    size_t operator()(int) const { return 42; }
+};
+
+void test_degenerate_hash() {
+    std::cout << "\n[Running test_degenerate_hash]" << std::endl;
+    flat_hash_map<int, int, same_hash> hm;
+    bool thrown = false;
+    int inserted = 0;
+    try {
+        for (int i = 0; i < 1000; ++i, ++inserted) hm[i] = i;
+    } catch (const std::overflow_error&) {
+        thrown = true;
+    }
+    assert(thrown && inserted > 100);
+    assert(hm.size() == static_cast<size_t>(inserted));
+    for (int i = 0; i < inserted; ++i) assert(hm[i] == i);
+}
+
+// 插入已存在的键不扩容; 插入的元素引用表中的元素时, 即使正好在装载率上限也安全
+void test_insert_existing() {
+    std::cout << "\n[Running test_insert_existing]" << std::endl;
+    for (int n = 1; n < 200; ++n) {
+        flat_hash_map<int, std::string> hm(0);
+        for (int i = 0; i < n; ++i) hm[i] = std::string(32, char('a' + i % 26));
+        const size_t buckets = hm.bucket_count();
+        flat_hash_map<int, std::string>::iterator first = hm.begin();
+        msl::pair<flat_hash_map<int, std::string>::iterator, bool> p = hm.insert(*first);
+        assert(!p.second && p.first == first);
+        assert(hm.bucket_count() == buckets && hm.size() == size_t(n));
+        assert(hm.begin() == first);
+    }
+}
+
+int main() {
+    print();
+    std::cout << "Starting flat_hash_map Tests..." << std::endl;
+
+    test_basic();
+    test_against_hash_map();
+    test_erase_while_iterating();
+    test_copy_and_equal();
+    test_degenerate_hash();
+    test_insert_existing();
+
+    std::cout << "\nAll tests passed successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <cassert>
+#include <string>
+#include "flat_hash_set.h"
+
+using namespace msl;
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+void test_basic() {
+    std::cout << "\n[Running test_basic]" << std::endl;
+    flat_hash_set<int> hs;
+    hs.insert(10);
+    hs.insert(20);
+    hs.insert(30);
+    assert(!hs.insert(10).second);
+    assert(hs.size() == 3 && hs.count(20) == 1 && hs.count(40) == 0);
+
+    int sum = 0;
+    for (flat_hash_set<int>::iterator it = hs.begin(); it != hs.end(); ++it) sum += *it;
+    assert(sum == 60);
+
+    assert(*hs.find(20) == 20 && hs.find(40) == hs.end());
+    hs.erase(hs.find(20));
+    assert(hs.erase(10) == 1 && hs.size() == 1);
+
+    int arr[] = {1, 2, 3, 2, 1};
+    flat_hash_set<int> hs2(arr, arr + 5);
+    assert(hs2.size() == 3);
+    flat_hash_set<int> hs3(hs2);
+    assert(hs2 == hs3);
+    hs3.insert(4);
+    assert(hs2 != hs3);
+    swap(hs2, hs3);
+    assert(hs2.size() == 4 && hs3.size() == 3);
+}
+
+void test_growth() {
+    std::cout << "\n[Running test_growth]" << std::endl;
+    flat_hash_set<std::string> hs(4);
+    size_t buckets = hs.bucket_count();
+    for (int i = 0; i < 5000; ++i) hs.insert(std::to_string(i * 7));
+    assert(hs.size() == 5000 && hs.bucket_count() > buckets);
+    for (int i = 0; i < 5000; ++i) assert(hs.count(std::to_string(i * 7)) == 1);
+    for (int i = 0; i < 5000; i += 2) assert(hs.erase(std::to_string(i * 7)) == 1);
+    for (int i = 0; i < 5000; ++i) assert(hs.count(std::to_string(i * 7)) == size_t(i % 2));
+
+    // resize 之后不再扩容, 槽位数不变
+    flat_hash_set<int> r;
+    r.resize(1000);
+    buckets = r.bucket_count();
+    for (int i = 0; i < 1000; ++i) r.insert(i);
+    assert(r.bucket_count() == buckets);
+    r.clear();
+    assert(r.empty() && r.bucket_count() == buckets && r.begin() == r.end());
+}
+
+int main() {
+    print();
+    std::cout << "Starting flat_hash_set Tests..." << std::endl;
+
+    test_basic();
+    test_growth();
+
+    std::cout << "\nAll tests passed successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "stl_hash_fun.h"
+#include "stl_hash_set.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <set>
+
+using namespace msl;
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+void test_string_hash() {
+    std::cout << "Testing string hash..." << std::endl;
+    hash<std::string> hs;
+    hash<const char*> hc;
+    assert(hs(std::string("hello")) == hc("hello"));
+    assert(hs(std::string("")) == hc(""));
+
+    // 每个长度下改动任意一个字节都会改变哈希值, 覆盖 <4, 4~16, 17~48, >48 几个分支
+    for (size_t len = 1; len <= 130; ++len) {
+        std::string s(len, 'a');
+        for (size_t i = 0; i < len; ++i) s[i] = char('a' + i % 26);
+        const size_t h = hs(s);
+        for (size_t i = 0; i < len; ++i) {
+            std::string t = s;
+            t[i] ^= 1;
+            assert(hs(t) != h);
+        }
+    }
+    // 只有长度不同的串
+    std::set<size_t> seen;
+    for (size_t len = 0; len < 100; ++len) seen.insert(hs(std::string(len, '\0')));
+    assert(seen.size() == 100);
+    std::cout << "Byte sensitivity successful." << std::endl;
+
+    // 低位的分布: 形如 key0001 的串落到 64 个桶中, 每个桶都不应过多
+    size_t buckets[64] = {0};
+    for (int i = 0; i < 6400; ++i) {
+        std::string s = "key" + std::to_string(i);
+        ++buckets[hs(s) & 63];
+    }
+    for (int i = 0; i < 64; ++i) assert(buckets[i] > 50 && buckets[i] < 150);
+    std::cout << "Distribution successful." << std::endl;
+
+    // 种子
+    assert(__hash_bytes("abc", 3, 1) != __hash_bytes("abc", 3, 2));
+}
+
+void test_float_hash() {
+    std::cout << "Testing floating point hash..." << std::endl;
+    hash<double> hd;
+    hash<float> hf;
+    assert(hd(0.0) == hd(-0.0));
+    assert(hf(0.0f) == hf(-0.0f));
+    assert(hd(1.0) != hd(-1.0));
+
+    // 源码的 size_t(d * 100) 会把 [0, 0.01) 都映射到 0
+    std::set<size_t> seen;
+    for (int i = 1; i <= 1000; ++i) seen.insert(hd(i * 1e-6));
+    assert(seen.size() == 1000);
+    seen.clear();
+    for (int i = 1; i <= 1000; ++i) seen.insert(hf(i * 1e-6f));
+    assert(seen.size() == 1000);
+
+    hash_set<double> s;
+    for (int i = 0; i < 1000; ++i) s.insert(i * 1e-5);
+    assert(s.size() == 1000);
+    assert(s.count(-0.0) == 1);
+    std::cout << "Floating point hash successful." << std::endl;
+}
+
+void test_integer_hash() {
+    std::cout << "Testing integer hash..." << std::endl;
+#ifdef MYSTL_HASH_MIX_INTEGERS
+    assert(hash<int>()(1) != 1);
+#else
+    assert(hash<int>()(12345) == 12345);
+#endif
+    assert(hash<long>()(7) == hash<unsigned long>()(7));
+
+    // __hash_mix: 输入翻转一位, 输出大约一半的位翻转
+    size_t total = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        const size_t d = __hash_mix(12345) ^ __hash_mix(12345 ^ (1ull << bit));
+        total += __builtin_popcountll(d);
+    }
+    assert(total > 64 * 24 && total < 64 * 40);
+    std::cout << "Integer hash successful." << std::endl;
+}
+
+int main() {
+    print();
+    test_string_hash();
+    print();
+    test_float_hash();
+    print();
+    test_integer_hash();
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cassert>
 #include <string>
+#include <cstdlib>
 
 using namespace msl;
 
@@ -111,8 +112,121 @@ void test_hash_map() {
     std::cout << "All hash_map tests passed!" << std::endl;
 }
 
+template <class Engine>
+void test_engine(const char* name) {
+    std::cout << "Testing hash_map with " << name << "..." << std::endl;
+    typedef hash_map<int, int, hash<int>, equal_to<int>, alloc, Engine> map_type;
+    typedef hash_map<int, int> reference_type;
+
+    map_type hm;
+    reference_type ref;
+    assert(hm.empty());
+
+    // 随机插入/删除, 和默认的链式实现对照, 删除会在表中留下墓碑
+    srand(7);
+    for (int i = 0; i < 20000; ++i) {
+        int k = rand() % 3000;
+        if (rand() % 3 == 0) {
+            assert(hm.erase(k) == ref.erase(k));
+        } else {
+            msl::pair<typename map_type::iterator, bool> p = hm.insert(msl::make_pair(k, i));
+            msl::pair<reference_type::iterator, bool> q = ref.insert(msl::make_pair(k, i));
+            assert(p.second == q.second);
+            assert(p.first->second == q.first->second);
+        }
+        assert(hm.size() == ref.size());
+    }
+    for (int k = 0; k < 3000; ++k) {
+        typename map_type::iterator it = hm.find(k);
+        reference_type::iterator jt = ref.find(k);
+        assert((it == hm.end()) == (jt == ref.end()));
+        if (it != hm.end()) assert(it->second == jt->second);
+    }
+    std::cout << "Random insert/erase successful." << std::endl;
+
+    // 遍历时删除
+    size_t n = 0;
+    for (typename map_type::iterator it = hm.begin(); it != hm.end(); ++it) ++n;
+    assert(n == hm.size());
+    for (int k = 0; k < 3000; k += 2) hm.erase(k);
+    for (typename map_type::const_iterator it = hm.begin(); it != hm.end(); ++it)
+        assert(it->first % 2 == 1);
+    std::cout << "Iteration successful." << std::endl;
+
+    // 遍历时用 it = erase(it) 删除, 每个元素都恰好访问一次
+    map_type em;
+    for (int i = 0; i < 3000; ++i) em[rand()] = i;
+    const size_t total = em.size();
+    size_t visited = 0, kept = 0;
+    for (typename map_type::iterator it = em.begin(); it != em.end(); ++visited) {
+        if (it->second % 2 == 0) {
+            it = em.erase(it);
+        } else {
+            ++kept;
+            ++it;
+        }
+    }
+    assert(visited == total);
+    assert(em.size() == kept);
+    for (typename map_type::iterator it = em.begin(); it != em.end(); ++it)
+        assert(it->second % 2 == 1);
+    std::cout << "Erase while iterating successful." << std::endl;
+
+    // 拷贝, 比较, 交换
+    map_type copy(hm);
+    assert(copy == hm);
+    copy[1] = -1;
+    copy[100001] = 1;
+    assert(!(copy == hm));
+    copy.swap(hm);
+    assert(hm.count(100001) == 1);
+    assert(copy.count(100001) == 0);
+    std::cout << "Copy/compare/swap successful." << std::endl;
+
+    // 增长
+    map_type big;
+    for (int i = 0; i < 100000; ++i) big[i] = i * 2;
+    assert(big.size() == 100000);
+    assert(big.bucket_count() >= big.size());
+    for (int i = 0; i < 100000; ++i) assert(big[i] == i * 2);
+    big.clear();
+    assert(big.empty());
+    assert(big.find(5) == big.end());
+    std::cout << "Growth successful." << std::endl;
+
+    // 插入表中已有的元素: 迭代器不失效, 正好在装载率上限时也不会读到已释放的元素
+    for (int n = 1; n < 300; ++n) {
+        hash_map<int, std::string, hash<int>, equal_to<int>, alloc, Engine> sm(0);
+        for (int i = 0; i < n; ++i) sm[i] = std::string(32, char('a' + i % 26));
+        typename hash_map<int, std::string, hash<int>, equal_to<int>, alloc, Engine>::iterator first = sm.begin();
+        const int k = first->first;
+        assert(!sm.insert(*first).second);
+        assert(sm.find(k) == first);
+        assert(first->second == std::string(32, char('a' + k % 26)));
+    }
+    std::cout << "Insert existing successful." << std::endl;
+
+    hash_map<std::string, int, hash<std::string>, equal_to<std::string>, alloc, Engine> sm;
+    sm["apple"] = 1;
+    sm["banana"] = 2;
+    assert(sm.erase("apple") == 1);
+    assert(sm.count("apple") == 0);
+    assert(sm["banana"] == 2);
+    std::cout << "String keys successful." << std::endl;
+}
+
 int main() {
     print();
     test_hash_map();
+    print();
+    test_engine<chained_hash_engine>("chained_hash_engine");
+    print();
+    test_engine<basic_chained_hash_engine<pow2_bucket_policy> >("basic_chained_hash_engine<pow2_bucket_policy>");
+    print();
+    test_engine<basic_chained_hash_engine<cached_hash_policy<pow2_bucket_policy> > >("basic_chained_hash_engine<cached_hash_policy<pow2_bucket_policy> >");
+    print();
+    test_engine<flat_hash_engine>("flat_hash_engine");
+    print();
+    test_engine<swiss_hash_engine>("swiss_hash_engine");
     return 0;
 }
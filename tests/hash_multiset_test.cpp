@@ -105,6 +105,17 @@ void test_hash_multiset() {
     assert(hs3.count(3) == 1);
     std::cout << "Range constructor successful." << std::endl;
 
+    // Test pow2 bucket policy and operator==
+    hash_multiset<int, hash<int>, equal_to<int>, alloc, pow2_bucket_policy> hs4(arr, arr + 5);
+    hash_multiset<int, hash<int>, equal_to<int>, alloc, pow2_bucket_policy> hs5(hs4);
+    assert(hs4.count(1) == 2);
+    assert(hs4 == hs5);
+    hs5.erase(hs5.find(1));
+    hs5.insert(3);
+    assert(hs4.size() == hs5.size());
+    assert(!(hs4 == hs5));
+    std::cout << "Bucket policy successful." << std::endl;
+
     std::cout << "All hash_multiset tests passed!" << std::endl;
 }
 
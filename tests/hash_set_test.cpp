@@ -93,8 +93,47 @@ void test_hash_set() {
     std::cout << "All hash_set tests passed!" << std::endl;
 }
 
+template <class Engine>
+void test_engine(const char* name) {
+    std::cout << "Testing hash_set with " << name << "..." << std::endl;
+    typedef hash_set<int, hash<int>, equal_to<int>, alloc, Engine> set_type;
+
+    set_type hs;
+    for (int i = 0; i < 5000; ++i) assert(hs.insert(i).second);
+    assert(!hs.insert(42).second);
+    assert(hs.size() == 5000);
+    for (int i = 0; i < 5000; i += 3) hs.erase(hs.find(i));
+    for (int i = 0; i < 5000; ++i) assert(hs.count(i) == (i % 3 != 0 ? 1u : 0u));
+    std::cout << "Insert/erase successful." << std::endl;
+
+    size_t visited = 0;
+    const size_t total = hs.size();
+    for (typename set_type::iterator it = hs.begin(); it != hs.end(); ++visited) {
+        if (*it % 2 == 0) it = hs.erase(it);
+        else ++it;
+    }
+    assert(visited == total);
+    for (int i = 0; i < 5000; ++i) assert(hs.count(i) == (i % 3 != 0 && i % 2 != 0 ? 1u : 0u));
+    std::cout << "Erase while iterating successful." << std::endl;
+
+    int arr[] = {1, 2, 3, 4, 5};
+    set_type hs2(arr, arr + 5);
+    set_type hs3(hs2);
+    assert(hs2 == hs3);
+    hs3.erase(3);
+    assert(!(hs2 == hs3));
+    assert(hs3.size() == 4);
+    std::cout << "Copy/compare successful." << std::endl;
+}
+
 int main() {
     print();
     test_hash_set();
+    print();
+    test_engine<chained_hash_engine>("chained_hash_engine");
+    print();
+    test_engine<flat_hash_engine>("flat_hash_engine");
+    print();
+    test_engine<swiss_hash_engine>("swiss_hash_engine");
     return 0;
 }
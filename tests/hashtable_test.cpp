@@ -129,10 +129,105 @@ void test_hashtable() {
     std::cout << "All basic tests passed!" << std::endl;
 }
 
+void test_pow2_bucket_policy() {
+    std::cout << "Testing pow2_bucket_policy..." << std::endl;
+    typedef hashtable<int, int, IntHash, IntIdentity, IntEqual, alloc, pow2_bucket_policy> pow2_table;
+    pow2_table ht(50, IntHash(), IntEqual());
+    assert(ht.bucket_count() == 64);
+
+    // 恒等哈希, 键都是 64 的倍数: 取低位会全部落进 0 号桶
+    for (int i = 0; i < 1000; ++i) assert(ht.insert_unique(i * 64).second);
+    assert(ht.size() == 1000);
+    assert(ht.bucket_count() == 1024);
+    size_t used = 0;
+    for (size_t b = 0; b < ht.bucket_count(); ++b) {
+        size_t n = 0;
+        for (pow2_table::iterator it = ht.begin(); it != ht.end(); ++it)
+            if (pow2_bucket_policy::index(IntHash()(*it), ht.bucket_count()) == b) ++n;
+        if (n) ++used;
+        assert(n <= 8);
+    }
+    assert(used > 500);
+    std::cout << "Distribution successful." << std::endl;
+
+    for (int i = 0; i < 1000; ++i) assert(ht.count(i * 64) == 1);
+    assert(ht.count(1) == 0);
+    for (int i = 0; i < 1000; i += 2) assert(ht.erase(i * 64) == 1);
+    size_t n = 0;
+    for (pow2_table::const_iterator it = ht.begin(); it != ht.end(); ++it) {
+        assert(*it % 128 == 64);
+        ++n;
+    }
+    assert(n == 500);
+
+    pow2_table copy(ht);
+    assert(copy == ht);
+    copy.insert_equal(64);
+    assert(!(copy == ht));
+    std::cout << "pow2_bucket_policy successful." << std::endl;
+}
+
+static int hash_calls = 0;
+static int equal_calls = 0;
 
+// 所有键都落进少数几个桶, 让链足够长
+struct CountingHash {
+    size_t operator()(int x) const { ++hash_calls; return (size_t)x; }
+};
+
+struct CountingEqual {
+    bool operator()(int a, int b) const { ++equal_calls; return a == b; }
+};
+
+void test_cached_hash_policy() {
+    std::cout << "Testing cached_hash_policy..." << std::endl;
+    typedef hashtable<int, int, CountingHash, IntIdentity, CountingEqual, alloc,
+                      cached_hash_policy<> > cached_table;
+    cached_table ht(10, CountingHash(), CountingEqual());
+    for (int i = 0; i < 20; ++i) ht.insert_unique(i * 53);    // 都在 53 个桶的 0 号桶中
+    assert(ht.size() == 20);
+
+    // 链上的其他节点哈希值不同, equals 只在命中时调用一次
+    equal_calls = 0;
+    assert(ht.count(19 * 53) == 1);
+    assert(ht.find(7 * 53) != ht.end());
+    assert(ht.find(20 * 53) == ht.end());
+    assert(equal_calls == 2);
+    std::cout << "Comparison skipping successful." << std::endl;
+
+    // 扩容和遍历使用保存的哈希值
+    hash_calls = 0;
+    for (int i = 20; i < 2000; ++i) ht.insert_unique(i);
+    assert(hash_calls == 1980);
+    hash_calls = 0;
+    size_t n = 0;
+    for (cached_table::iterator it = ht.begin(); it != ht.end(); ++it) ++n;
+    assert(n == ht.size());
+    assert(hash_calls == 0);
+    std::cout << "Rehash without hashing successful." << std::endl;
+
+    // 重复键, 删除, 拷贝
+    ht.insert_equal(25);
+    assert(ht.count(25) == 2);
+    assert(ht.erase(25) == 2);
+    assert(ht.count(25) == 0);
+    cached_table copy(ht);
+    assert(copy == ht);
+    hash_calls = 0;
+    for (cached_table::iterator it = copy.begin(); it != copy.end(); ++it) {}
+    assert(hash_calls == 0);
+    copy.erase(copy.find(19 * 53));
+    assert(copy.count(19 * 53) == 0);
+    assert(copy.size() == ht.size() - 1);
+    std::cout << "cached_hash_policy successful." << std::endl;
+}
 
 int main() {
     print();
     test_hashtable();
+    print();
+    test_pow2_bucket_policy();
+    print();
+    test_cached_hash_policy();
     return 0;
 }
@@ -0,0 +1,161 @@
+#include "mmap_vector.h"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+#ifdef MYSTL_PLATFORM_LINUX
+
+struct record {
+    int id;
+    double value;
+    char tag[4];
+};
+
+const char* path = "/tmp/msl_mmap_vector_test.bin";
+
+void test_write() {
+    std::cout << "\n[Running test_write]" << std::endl;
+    std::remove(path);
+    msl::mmap_vector<record> v(path, msl::mmap_read_write);
+    assert(v.is_open() && v.writable() && v.empty());
+    for (int i = 0; i < 10000; ++i) {
+        record r = { i, i * 0.5, "ab" };
+        v.push_back(r);
+    }
+    assert(v.size() == 10000 && v.capacity() >= 10000);
+    v.push_back(v[0]);          // the source lives in the mapping
+    assert(v.back().id == 0);
+    v.pop_back();
+    v.sync();
+}
+
+void test_read() {
+    std::cout << "\n[Running test_read]" << std::endl;
+    msl::mmap_vector<record> v(path);
+    assert(v.size() == 10000 && v.capacity() == 10000);   // close() trimmed the reserve
+    long sum = 0;
+    for (const record* it = v.begin(); it != v.end(); ++it) sum += it->id;
+    assert(sum == 10000L * 9999 / 2 && v[123].value == 61.5 && v.data()[9999].tag[1] == 'b');
+
+    v[0].id = -1;               // private copy-on-write, never reaches the file
+    bool threw = false;
+    try { v.push_back(v[0]); } catch (const std::logic_error&) { threw = true; }
+    assert(threw);
+    v.close();
+    msl::mmap_vector<record> again(path);
+    assert(again[0].id == 0);
+}
+
+void test_resize() {
+    std::cout << "\n[Running test_resize]" << std::endl;
+    {
+        msl::mmap_vector<record> v(path, msl::mmap_read_write);
+        v.resize(10);
+        v.shrink_to_fit();
+        assert(v.size() == 10 && v.capacity() == 10 && v[9].id == 9);
+        record r = { 7, 0, "" };
+        v.resize(20, r);
+        assert(v[19].id == 7 && v[9].id == 9);
+    }
+    msl::mmap_vector<record> v(path);
+    assert(v.size() == 20);
+    assert(v.close());
+    assert(v.close());          // closing twice is harmless
+    v.open(path);
+
+    std::FILE* f = std::fopen(path, "ab");
+    std::fputc(0, f);
+    std::fclose(f);
+    bool threw = false;
+    try { msl::mmap_vector<record> bad(path); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    std::remove(path);
+}
+
+// 元素比一页还大时, 第一次 push_back 也要能扩容
+struct big_record {
+    char bytes[8192];
+};
+
+void test_large_element() {
+    std::cout << "\n[Running test_large_element]" << std::endl;
+    std::remove(path);
+    {
+        msl::mmap_vector<big_record> v(path, msl::mmap_read_write);
+        big_record r;
+        for (int i = 0; i < 5; ++i) {
+            r.bytes[0] = char('a' + i);
+            r.bytes[8191] = char(i);
+            v.push_back(r);
+        }
+        assert(v.size() == 5 && v.capacity() >= 5);
+    }
+    msl::mmap_vector<big_record> v(path);
+    assert(v.size() == 5 && v[3].bytes[0] == 'd' && v[4].bytes[8191] == 4);
+    v.close();
+    std::remove(path);
+}
+
+// 映射失败时文件恢复原来的大小: 在子进程中限制地址空间, 让扩容的 mmap 失败
+void test_remap_failure() {
+    std::cout << "\n[Running test_remap_failure]" << std::endl;
+    std::remove(path);
+    {
+        msl::mmap_vector<record> v(path, msl::mmap_read_write);
+        v.resize(100);
+        v.shrink_to_fit();
+    }
+    const off_t before = 100 * sizeof(record);
+    std::fflush(0);
+    pid_t pid = fork();
+    if (pid == 0) {
+        msl::mmap_vector<record> v(path, msl::mmap_read_write);
+        long pages = 0;
+        std::FILE* f = std::fopen("/proc/self/statm", "r");
+        if (!f || std::fscanf(f, "%ld", &pages) != 1) _exit(2);
+        std::fclose(f);
+        struct rlimit lim;
+        lim.rlim_cur = lim.rlim_max = static_cast<rlim_t>(pages) * sysconf(_SC_PAGESIZE) + (64 << 20);
+        if (setrlimit(RLIMIT_AS, &lim) != 0) _exit(2);
+        bool threw = false;
+        try { v.reserve((size_t(1) << 30) / sizeof(record)); } catch (const std::runtime_error&) { threw = true; }
+        _exit(threw && v.capacity() == 100 ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    struct stat st;
+    assert(stat(path, &st) == 0 && st.st_size == before);
+    std::remove(path);
+}
+
+int main() {
+    print();
+    std::cout << "Starting mmap_vector Tests..." << std::endl;
+
+    test_write();
+    test_read();
+    test_resize();
+    test_large_element();
+    test_remap_failure();
+
+    std::cout << "\nAll tests passed successfully!" << std::endl;
+    return 0;
+}
+
+#else
+
+int main() {
+    print();
+    std::cout << "mmap_vector is only available on Linux" << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include "small_vector.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <map>
+
+void print(){
+    std::cout << "==========================================" << std::endl;
+}
+
+// Counts the blocks that reach the heap
+struct counting_alloc {
+    static size_t allocs;
+    static void* allocate(size_t n) { ++allocs; return msl::alloc::allocate(n); }
+    static void deallocate(void* p, size_t n) { msl::alloc::deallocate(p, n); }
+    static void* reallocate(void* p, size_t old_sz, size_t new_sz) {
+        ++allocs;
+        return msl::alloc::reallocate(p, old_sz, new_sz);
+    }
+};
+size_t counting_alloc::allocs = 0;
+
+typedef msl::small_vector<int, 8, counting_alloc> small_ints;
+
+size_t heap_allocs() { return counting_alloc::allocs; }
+
+void test_inline() {
+    std::cout << "\n[Running test_inline]" << std::endl;
+    size_t before = heap_allocs();
+    small_ints v;
+    assert(v.empty() && v.capacity() == 8 && v.is_inline());
+    for (int i = 0; i < 7; ++i) v.push_back(i);
+    v.insert(v.begin(), -1);
+    v.erase(v.begin());
+    v.emplace_back(7);
+    assert(v.size() == 8 && v.is_inline());
+    assert(heap_allocs() == before);
+    for (int i = 0; i < 8; ++i) assert(v[i] == i);
+
+    small_ints w(5, 7);
+    assert(w.is_inline() && w.size() == 5 && w.capacity() == 8 && w.back() == 7);
+    small_ints l = {1, 2, 3};
+    assert(l.is_inline() && l.size() == 3 && l[2] == 3);
+    assert(heap_allocs() == before);
+}
+
+void test_spill() {
+    std::cout << "\n[Running test_spill]" << std::endl;
+    small_ints v;
+    for (int i = 0; i < 100; ++i) v.push_back(i);
+    assert(!v.is_inline() && v.capacity() >= 100);
+    for (int i = 0; i < 100; ++i) assert(v[i] == i);
+
+    v.erase(v.begin() + 4, v.end());
+    v.shrink_to_fit();
+    assert(v.is_inline() && v.capacity() == 8 && v.size() == 4 && v[3] == 3);
+    for (int i = 4; i < 20; ++i) v.push_back(i);
+    v.shrink_to_fit();
+    assert(!v.is_inline() && v.capacity() == 20);
+    for (int i = 0; i < 20; ++i) assert(v[i] == i);
+}
+
+void test_copy_move_swap() {
+    std::cout << "\n[Running test_copy_move_swap]" << std::endl;
+    msl::small_vector<std::string, 4> a;
+    a.push_back("one");
+    a.push_back("two");
+    msl::small_vector<std::string, 4> b(a);
+    assert(b.is_inline() && b.size() == 2 && b[1] == "two" && a[1] == "two");
+
+    msl::small_vector<std::string, 4> c(msl::move(b));
+    assert(c.is_inline() && c.size() == 2 && c[0] == "one" && b.empty());
+
+    msl::small_vector<std::string, 4> big;
+    for (int i = 0; i < 10; ++i) big.push_back(std::string(20, char('a' + i)));
+    const std::string* heap = big.data();
+    msl::small_vector<std::string, 4> d(msl::move(big));
+    assert(d.data() == heap && big.empty() && big.is_inline() && big.capacity() == 4);
+    big.push_back("again");
+    assert(big.is_inline() && big[0] == "again");
+
+    c.swap(d);
+    assert(c.size() == 10 && c.data() == heap && d.size() == 2 && d.is_inline() && d[1] == "two");
+    msl::swap(c, d);
+    assert(d.size() == 10 && c.size() == 2 && c[0] == "one");
+
+    c = d;
+    assert(c.size() == 10 && !c.is_inline() && c[9] == d[9]);
+    d = a;
+    assert(d.size() == 2 && d[0] == "one");
+    c = msl::move(d);
+    assert(c.size() == 2 && c[1] == "two" && d.empty());
+    c = {"x", "y", "z"};
+    assert(c.size() == 3 && c[2] == "z");
+}
+
+// 有状态的配置器: 记录每个块由哪个实例分配, 释放时检查是同一个实例
+std::map<void*, int> block_owner;
+
+struct tagged_alloc {
+    int id;
+    explicit tagged_alloc(int i = 0) : id(i) {}
+    void* allocate(size_t n) const {
+        void* p = msl::alloc::allocate(n);
+        block_owner[p] = id;
+        return p;
+    }
+    void deallocate(void* p, size_t n) const {
+        assert(block_owner[p] == id);
+        block_owner.erase(p);
+        msl::alloc::deallocate(p, n);
+    }
+    void* reallocate(void* p, size_t old_sz, size_t new_sz) const {
+        void* r = allocate(new_sz);
+        memcpy(r, p, old_sz < new_sz ? old_sz : new_sz);
+        deallocate(p, old_sz);
+        return r;
+    }
+};
+
+void test_noexcept_and_allocators() {
+    std::cout << "\n[Running test_noexcept_and_allocators]" << std::endl;
+    static_assert(msl::is_nothrow_move_constructible<msl::small_vector<std::string, 2> >::value,
+                  "small_vector<std::string> should be nothrow movable");
+    static_assert(msl::relocate_with_move<msl::small_vector<std::string, 2> >::value,
+                  "vector should move small_vector elements on reallocation");
+
+    // vector 扩容时移动元素, 堆上的存储区原样转移
+    msl::vector<msl::small_vector<std::string, 2> > vv;
+    vv.push_back(msl::small_vector<std::string, 2>(5, std::string(20, 'x')));
+    const std::string* heap = vv[0].data();
+    for (int i = 0; i < 100; ++i) vv.push_back(msl::small_vector<std::string, 2>(1, "y"));
+    assert(vv[0].data() == heap && vv[0].size() == 5 && vv[100][0] == "y");
+
+    // 两者都在堆上时 swap 交换配置器, 之后各自的存储区释放回分配它的配置器
+    typedef msl::small_vector<int, 2, tagged_alloc> tagged_vec;
+    {
+        tagged_vec a((tagged_alloc(1))), b((tagged_alloc(2)));
+        for (int i = 0; i < 10; ++i) a.push_back(i);
+        for (int i = 0; i < 20; ++i) b.push_back(i);
+        a.swap(b);
+        assert(a.size() == 20 && b.size() == 10);
+        assert(a.get_allocator().base().id == 2 && b.get_allocator().base().id == 1);
+        for (int i = 20; i < 100; ++i) a.push_back(i);
+        b.shrink_to_fit();
+
+        tagged_vec c((tagged_alloc(3)));
+        c = msl::move(a);
+        assert(c.size() == 100 && c.get_allocator().base().id == 2);
+        c.push_back(100);
+    }
+    assert(block_owner.empty());
+}
+
+int main() {
+    print();
+    std::cout << "Starting small_vector Tests..." << std::endl;
+
+    test_inline();
+    test_spill();
+    test_copy_move_swap();
+    test_noexcept_and_allocators();
+
+    std::cout << "\nAll tests passed successfully!" << std::endl;
+    return 0;
+}
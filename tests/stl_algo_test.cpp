@@ -2362,6 +2362,133 @@ void test_stable_sort() {
     }
 }
 
+// 逐个比较的参考结果, 用来核对原生指针上的 SIMD 内核
+template <typename T>
+bool check_simd_kernels(const T* data, size_t n, T value) {
+    const T* last = data + n;
+    const T* ref_find = data;
+    while (ref_find != last && !(*ref_find == value)) ++ref_find;
+    ptrdiff_t ref_count = 0;
+    for (const T* p = data; p != last; ++p) ref_count += (*p == value);
+
+    bool pass = msl::find(data, last, value) == ref_find;
+    pass &= msl::count(data, last, value) == ref_count;
+
+    std::vector<T> other(data, last);
+    pass &= msl::equal(data, last, other.data());
+    pass &= msl::mismatch(data, last, other.data()).first == last;
+    for (size_t i = 0; i < n; i += 7) {
+        other[i] = static_cast<T>(other[i] + 1);
+        msl::pair<const T*, T*> mm = msl::mismatch(data, last, other.data());
+        pass &= mm.first == data + i && mm.second == other.data() + i;
+        pass &= !msl::equal(data, last, other.data());
+        other[i] = data[i];
+#ifdef MYSTL_HAS_SIMD_KERNELS
+        other[i] = static_cast<T>(other[i] + 1);
+        pass &= msl::__simd_sse2::mismatch(data, last, other.data()) == i;
+        other[i] = data[i];
+#endif
+    }
+#ifdef MYSTL_HAS_SIMD_KERNELS
+    pass &= msl::__simd_sse2::find(data, last, value) == ref_find;
+    pass &= msl::__simd_sse2::count(data, last, value) == static_cast<size_t>(ref_count);
+#endif
+    return pass;
+}
+
+template <typename T>
+bool check_simd_min_max(const T* data, size_t n) {
+    const T* last = data + n;
+    const T* ref_min = data;
+    const T* ref_max = data;
+    for (const T* p = data; p != last; ++p) {
+        if (*p < *ref_min) ref_min = p;
+        if (*ref_max < *p) ref_max = p;
+    }
+    return msl::min_element(data, last) == ref_min && msl::max_element(data, last) == ref_max;
+}
+
+template <typename T>
+bool check_simd_type() {
+    bool pass = true;
+    unsigned seed = 12345;
+    for (size_t n = 0; n < 150; n += (n < 70 ? 1 : 13)) {
+        std::vector<T> v(n);
+        for (size_t i = 0; i < n; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            v[i] = static_cast<T>(static_cast<int>(seed >> 16) % 23 - 11);
+        }
+        pass &= check_simd_kernels(v.data(), n, static_cast<T>(3));
+        pass &= check_simd_kernels(v.data(), n, static_cast<T>(100));
+        if (n) pass &= check_simd_kernels(v.data(), n, v[n - 1]);
+        pass &= check_simd_min_max(v.data(), n);
+    }
+    return pass;
+}
+
+void test_simd_kernels() {
+    // ==========================================
+    // 测试原生指针上的 find/count/equal/mismatch/min/max 内核
+    // ==========================================
+    print();
+    std::cout << "Testing SIMD kernels..." << std::endl;
+
+    bool pass = check_simd_type<signed char>() && check_simd_type<unsigned char>() &&
+                check_simd_type<char>() && check_simd_type<short>() &&
+                check_simd_type<unsigned short>() && check_simd_type<int>() &&
+                check_simd_type<unsigned int>() && check_simd_type<long long>() &&
+                check_simd_type<unsigned long long>() && check_simd_type<float>() &&
+                check_simd_type<double>();
+    std::cout << "Test Case simd (all types): " << (pass ? "PASSED" : "FAILED") << std::endl;
+
+    // 浮点数: NaN 与自身不相等, +0.0 与 -0.0 相等
+    {
+        double nan = std::nan("");
+        double a[40];
+        for (int i = 0; i < 40; ++i) a[i] = i;
+        a[33] = nan;
+        a[35] = -0.0;
+        double b[40];
+        for (int i = 0; i < 40; ++i) b[i] = a[i];
+        bool fp = msl::find(a, a + 40, nan) == a + 40 && msl::count(a, a + 40, 0.0) == 2;
+        fp &= msl::mismatch(a, a + 40, b).first == a + 33 && !msl::equal(a, a + 40, b);
+        fp &= msl::min_element(a, a + 40) == a;
+        std::cout << "Test Case simd (floating point): " << (fp ? "PASSED" : "FAILED") << std::endl;
+    }
+
+    // 无符号数的大小不能按有符号比较
+    {
+        unsigned int u[37];
+        for (int i = 0; i < 37; ++i) u[i] = static_cast<unsigned int>(i);
+        u[20] = 0x90000000u;
+        unsigned short h[50];
+        for (int i = 0; i < 50; ++i) h[i] = static_cast<unsigned short>(i + 1);
+        h[41] = 0xfff0;
+        bool un = msl::max_element(u, u + 37) == u + 20 && msl::min_element(u, u + 37) == u;
+        un &= msl::max_element(h, h + 50) == h + 41 && *msl::min_element(h, h + 50) == 1;
+#ifdef MYSTL_HAS_SIMD_KERNELS
+        un &= msl::__simd_sse2::extreme<true>(u, u + 37) == 0x90000000u;
+        un &= msl::__simd_sse2::extreme<false>(u, u + 37) == 0u;
+        un &= msl::__simd_sse2::extreme<true>(h, h + 50) == 0xfff0;
+        un &= msl::__simd_sse2::extreme<false>(h, h + 50) == 1;
+        signed char c[40];
+        for (int i = 0; i < 40; ++i) c[i] = static_cast<signed char>(i - 20);
+        un &= msl::__simd_sse2::extreme<false>(c, c + 40) == -20;
+        un &= msl::__simd_sse2::extreme<true>(c, c + 40) == 19;
+#endif
+        std::cout << "Test Case simd (unsigned order): " << (un ? "PASSED" : "FAILED") << std::endl;
+    }
+
+    // vector 的 == 使用同一套内核
+    {
+        msl::vector<int> x(1000, 7), y(1000, 7);
+        bool eq = (x == y);
+        y[999] = 8;
+        eq &= !(x == y) && x != y;
+        std::cout << "Test Case simd (vector ==): " << (eq ? "PASSED" : "FAILED") << std::endl;
+    }
+}
+
 int main() {
     test_sort();
     std::cout << std::endl;
@@ -2440,6 +2567,8 @@ int main() {
     test_unique();
     std::cout << std::endl;
     test_unique_copy();
+    std::cout << std::endl;
+    test_simd_kernels();
     return 0;
 
 }
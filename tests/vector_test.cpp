@@ -3,6 +3,8 @@
 #include <cassert>
 #include <string>
 #include <stdexcept>
+#include <sstream>
+#include "list.h"
 
 void print(){
     std::cout << "==========================================" << std::endl;
@@ -189,6 +191,13 @@ void test_clear() {
     print_vec("After clear");
     assert(g_vec.empty());
     assert(g_vec.size() == 0);
+
+    // 空 vector 的 clear/erase/insert 不应把空指针传给 memmove
+    msl::vector<int> empty;
+    empty.clear();
+    empty.erase(empty.begin(), empty.end());
+    empty.insert(empty.end(), 2, 5);
+    assert(empty.size() == 2 && empty[1] == 5);
 }
 
 // 13. Test assign
@@ -224,6 +233,303 @@ void test_utils() {
     g_vec.get_allocator();
 }
 
+// 15. Test growth through the allocator's reallocate
+void test_realloc_growth() {
+    std::cout << "\n[Running test_realloc_growth]" << std::endl;
+    // The arena extends its most recent block in place, so a lone vector never moves
+    msl::arena ar(1 << 16);
+    msl::vector<int, msl::arena_alloc> v((msl::arena_alloc(ar)));
+    v.push_back(0);
+    const int* first = v.data();
+    for (int i = 1; i < 5000; ++i) v.push_back(i);
+    assert(v.data() == first);
+    for (int i = 0; i < 5000; ++i) assert(v[i] == i);
+
+    // Inserting an element of the vector itself must survive the reallocation
+    msl::vector<long> w;
+    for (long i = 0; i < 100; ++i) w.push_back(i);
+    while (w.size() != w.capacity()) w.push_back(7);
+    w.push_back(w[0]);
+    w.insert(w.begin(), w[1]);
+    assert(w.back() == 0 && w.front() == 1 && w[1] == 0 && w[2] == 1);
+    w.emplace(w.begin() + 2, 42L);
+    assert(w[2] == 42 && w[3] == 1);
+    w.reserve(w.capacity() * 4);
+    assert(w[0] == 1 && w[2] == 42 && w[4] == 2 && w.back() == 0);
+}
+
+void test_growth_policy() {
+    std::cout << "\n[Running test_growth_policy]" << std::endl;
+    msl::vector<int, msl::alloc, msl::vector_growth_1_5> v;
+    const size_t expect[] = {1, 2, 3, 4, 6, 9, 13, 19, 28, 42};
+    size_t k = 0;
+    for (int i = 0; i < 42; ++i) {
+        v.push_back(i);
+        if (v.capacity() != expect[k]) { ++k; assert(v.capacity() == expect[k]); }
+    }
+    assert(k == 9);
+    for (int i = 0; i < 42; ++i) assert(v[i] == i);
+
+    // 64 bytes per step == 16 ints
+    msl::vector<int, msl::alloc, msl::vector_growth_capped<64> > c;
+    for (int i = 0; i < 100; ++i) c.push_back(i);
+    assert(c.capacity() == 112);
+    c.insert(c.end(), 200, 1);
+    assert(c.size() == 300 && c.capacity() == 300);
+
+    // Capacity is rounded up to the pool size classes, so no tail is wasted
+    typedef msl::vector<char, msl::pool_alloc,
+                        msl::vector_growth_size_class<msl::vector_growth_1_5> > sc_vector;
+    sc_vector s;
+    for (int i = 0; i < 1000; ++i) {
+        s.push_back(char(i));
+        assert(s.capacity() == msl::pool_alloc::good_size(s.capacity()));
+    }
+    sc_vector r;
+    r.reserve(130);
+    assert(r.capacity() == 160);
+    msl::vector<char, msl::default_alloc, msl::vector_growth_size_class<> > d;
+    d.reserve(13);
+    assert(d.capacity() == 16);
+}
+
+// Owns a heap int; counts the moves so the test can see whether growth relocated bytes
+struct handle {
+    static int live, moves;
+    int* p;
+    explicit handle(int v = 0) : p(new int(v)) { ++live; }
+    handle(const handle& x) : p(new int(*x.p)) { ++live; }
+    handle(handle&& x) : p(x.p) { x.p = 0; ++live; ++moves; }
+    handle& operator=(const handle& x) { *p = *x.p; return *this; }
+    handle& operator=(handle&& x) { int* t = p; p = x.p; x.p = t; ++moves; return *this; }
+    ~handle() { delete p; --live; }
+};
+int handle::live = 0;
+int handle::moves = 0;
+
+namespace msl {
+template <> struct is_trivially_relocatable<handle> : public true_type {};
+}
+
+void test_trivially_relocatable() {
+    std::cout << "\n[Running test_trivially_relocatable]" << std::endl;
+    assert(msl::is_trivially_relocatable<int>::value);
+    assert(!msl::is_trivially_relocatable<std::string>::value);
+    assert((msl::is_trivially_relocatable<msl::pair<int, handle> >::value));
+    assert((!msl::is_trivially_relocatable<msl::pair<int, std::string> >::value));
+    assert(msl::is_trivially_relocatable<msl::vector<std::string> >::value);
+    {
+        msl::vector<handle> v;
+        for (int i = 0; i < 1000; ++i) v.emplace_back(i);
+        handle::moves = 0;
+        for (int i = 1000; i < 5000; ++i) v.emplace_back(i);
+        assert(handle::moves <= 20);   // only the temporaries built before each reallocation
+        for (int i = 0; i < 5000; ++i) assert(*v[i].p == i);
+
+        v.insert(v.begin(), v[10]);
+        v.insert(v.begin() + 1, handle(-1));
+        v.emplace(v.begin() + 2, -2);
+        assert(*v[0].p == 10 && *v[1].p == -1 && *v[2].p == -2 && *v[3].p == 0);
+        v.erase(v.begin(), v.begin() + 3);
+        v.erase(v.begin() + 100);
+        assert(v.size() == 4999 && *v[99].p == 99 && *v[100].p == 101);
+        v.erase(v.begin() + 10, v.end());
+        v.shrink_to_fit();
+        assert(v.capacity() == 10);
+        for (int i = 0; i < 10; ++i) assert(*v[i].p == i);
+        assert(handle::live == 10);
+    }
+    assert(handle::live == 0);
+
+    msl::vector<msl::vector<int> > vv;
+    for (int i = 0; i < 100; ++i) vv.push_back(msl::vector<int>(i, i));
+    vv.erase(vv.begin());
+    for (int i = 1; i < 100; ++i) assert(vv[i - 1].size() == (size_t)i && vv[i - 1].back() == i);
+}
+
+struct pod_record {
+    int id;
+    char tag[12];
+};
+
+void test_resize_default_init() {
+    std::cout << "\n[Running test_resize_default_init]" << std::endl;
+    msl::vector<int> v(100, 7);
+    const int* storage = v.data();
+    v.clear();
+    v.resize_default_init(100);     // trivial: the old bytes are left untouched
+    assert(v.size() == 100 && v.data() == storage && v[0] == 7 && v[99] == 7);
+    v.resize_uninitialized(1000);
+    for (int i = 100; i < 1000; ++i) v[i] = i;
+    assert(v.size() == 1000 && v[0] == 7 && v[999] == 999);
+    v.resize_default_init(10);
+    assert(v.size() == 10);
+
+    msl::vector<std::string> s(2, "x");
+    s.resize_default_init(5);
+    assert(s.size() == 5 && s[1] == "x" && s[4].empty());
+
+    // 反复在末尾追加一段: 按扩容策略增长, 重新分配的次数是对数级的
+    msl::vector<char> buf;
+    size_t reallocs = 0;
+    for (int i = 0; i < 10000; ++i) {
+        const size_t cap = buf.capacity();
+        buf.resize_default_init(buf.size() + 64);
+        buf[buf.size() - 1] = char(i);
+        if (buf.capacity() != cap) ++reallocs;
+    }
+    assert(buf.size() == 640000 && buf[639999] == char(9999) && reallocs < 40);
+
+    // 没有特化 type_traits 的 POD 结构体也可以不初始化
+    msl::vector<pod_record> records;
+    records.resize_uninitialized(100);
+    for (int i = 0; i < 100; ++i) records[i].id = i;
+    assert(records.size() == 100 && records[99].id == 99);
+}
+
+void test_append_range() {
+    std::cout << "\n[Running test_append_range]" << std::endl;
+    msl::list<int> l;
+    for (int i = 0; i < 1000; ++i) l.push_back(i);
+    msl::vector<int> v;
+    v.push_back(-1);
+    v.append_range(l);
+    assert(v.size() == 1001 && v.capacity() == 1001);   // one reallocation, exact size
+    for (int i = 0; i < 1000; ++i) assert(v[i + 1] == i);
+
+    msl::vector<int> w(v.begin(), v.begin() + 3);
+    w.insert(w.begin() + 1, l.begin(), l.end());
+    assert(w.size() == 1003 && w[0] == -1 && w[1] == 0 && w[1000] == 999 && w[1001] == 0 && w[1002] == 1);
+
+    // Input iterators: unsized, inserted in the middle
+    std::istringstream in("5 6 7 8");
+    msl::vector<std::string> s(2, "x");
+    s.insert(s.begin() + 1, msl::istream_iterator<std::string>(in), msl::istream_iterator<std::string>());
+    assert(s.size() == 6 && s[0] == "x" && s[1] == "5" && s[4] == "8" && s[5] == "x");
+    std::istringstream in2("1 2");
+    s.append_range(msl::istream_iterator<std::string>(in2), msl::istream_iterator<std::string>());
+    assert(s.size() == 8 && s[7] == "2");
+
+    msl::vector<std::string> t;
+    t.append_range(s);
+    t.insert(t.begin(), s.begin(), s.begin() + 2);
+    assert(t.size() == 10 && t[0] == "x" && t[1] == "5" && t[2] == "x");
+}
+
+void test_vector_bool() {
+    std::cout << "\n[Running test_vector_bool]" << std::endl;
+    msl::vector<bool> v;
+    for (int i = 0; i < 1000; ++i) v.push_back(i % 3 == 0);
+    assert(v.size() == 1000 && v.capacity() >= 1000 && v.capacity() % 64 == 0);
+    assert(v.count() == 334 && v.count(false) == 666);
+    for (int i = 0; i < 1000; ++i) assert(v[i] == (i % 3 == 0));
+
+    v[0] = false;
+    v[1] = v[3];
+    v.back().flip();
+    assert(!v.front() && v[1] && v.back() == !(999 % 3 == 0));
+    assert(v.find(true) == v.begin() + 1 && v.find(false) == v.begin());
+
+    msl::vector<bool> z(130, false);
+    assert(z.find(true) == z.end() && z.count() == 0);
+    z[129] = true;
+    assert(z.find(true) - z.begin() == 129);
+    z.flip();
+    assert(z.count() == 129 && z.find(false) - z.begin() == 129);
+    z.fill(false);
+    assert(z.count() == 0 && z.size() == 130);
+
+    msl::vector<bool> a(200, true), b(200, false);
+    for (int i = 0; i < 200; i += 2) b[i] = true;
+    msl::vector<bool> c(a);
+    c &= b;
+    assert(c == b && c.count() == 100);
+    c |= a;
+    assert(c == a);
+    c ^= b;
+    assert(c.count() == 100 && !c[0] && c[1]);
+    bool threw = false;
+    try { c &= z; } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    msl::vector<bool> w(5, false);
+    w.insert(w.begin() + 2, true);
+    w.insert(w.begin(), 70, true);
+    assert(w.size() == 76 && w.count() == 71 && w[72] && !w[70] && !w[71]);
+    w.erase(w.begin(), w.begin() + 70);
+    assert(w.size() == 6 && w.count() == 1 && w[2]);
+    w.insert(w.end(), a.begin(), a.begin() + 10);
+    assert(w.size() == 16 && w.count() == 11);
+    w.resize(3);
+    w.shrink_to_fit();
+    assert(w.capacity() == 64 && w.size() == 3 && w[2]);
+    msl::vector<bool> e = {true, false, true};
+    assert(e.size() == 3 && e.count() == 2);
+    assert(e != w && e > w);
+    e.swap(w);
+    assert(w.count() == 2 && e.size() == 3 && e[2]);
+    size_t n = 0;
+    for (msl::vector<bool>::const_iterator it = a.begin(); it != a.end(); ++it) n += *it;
+    assert(n == 200);
+}
+
+// Move constructor may throw: growth must copy so a failure leaves the vector intact
+struct risky {
+    static int copies, moves, copies_left;
+    int v;
+    explicit risky(int x = 0) : v(x) {}
+    risky(const risky& x) : v(x.v) {
+        if (copies_left-- == 0) throw std::runtime_error("copy");
+        ++copies;
+    }
+    risky(risky&& x) noexcept(false) : v(x.v) { ++moves; }
+    risky& operator=(const risky& x) { v = x.v; return *this; }
+};
+int risky::copies = 0;
+int risky::moves = 0;
+int risky::copies_left = -1;
+
+struct safe_move {
+    static int copies;
+    int v;
+    explicit safe_move(int x = 0) : v(x) {}
+    safe_move(const safe_move& x) : v(x.v) { ++copies; }
+    safe_move(safe_move&& x) noexcept : v(x.v) {}
+    safe_move& operator=(const safe_move& x) { v = x.v; return *this; }
+};
+int safe_move::copies = 0;
+
+void test_move_if_noexcept() {
+    std::cout << "\n[Running test_move_if_noexcept]" << std::endl;
+    assert(!msl::relocate_with_move<risky>::value);
+    assert(msl::relocate_with_move<safe_move>::value);
+    assert(msl::relocate_with_move<int>::value && msl::relocate_with_move<std::string>::value);
+
+    msl::vector<safe_move> s;
+    for (int i = 0; i < 100; ++i) s.emplace_back(i);
+    assert(safe_move::copies == 0 && s[99].v == 99);
+
+    msl::vector<risky> v;
+    for (int i = 0; i < 16; ++i) v.emplace_back(i);
+    assert(v.size() == v.capacity());
+    risky::copies = risky::moves = 0;
+    risky::copies_left = 5;     // the 6th copy of the reallocation throws
+    bool threw = false;
+    try { v.emplace_back(16); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw && risky::moves == 0);
+    assert(v.size() == 16 && v.capacity() == 16);
+    for (int i = 0; i < 16; ++i) assert(v[i].v == i);
+
+    risky::copies_left = 3;
+    threw = false;
+    try { v.reserve(100); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw && v.capacity() == 16 && v[15].v == 15);
+
+    risky::copies_left = -1;
+    v.insert(v.begin() + 3, 4, risky(-1));
+    assert(v.size() == 20 && v[3].v == -1 && v[7].v == 3 && risky::moves == 0);
+}
+
 int main() {
     print();
     std::cout << "Starting Vector Tests (C++11)..." << std::endl;
@@ -242,6 +548,13 @@ int main() {
     test_clear();
     test_assign();
     test_utils();
+    test_realloc_growth();
+    test_growth_policy();
+    test_trivially_relocatable();
+    test_resize_default_init();
+    test_append_range();
+    test_vector_bool();
+    test_move_if_noexcept();
 
     std::cout << "\nAll tests passed successfully!" << std::endl;
     return 0;